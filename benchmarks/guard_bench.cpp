@@ -0,0 +1,494 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "config.h"
+
+#include "libguard/guard_codec.hpp"
+#include "libguard/guard_crc.hpp"
+#include "libguard/guard_entity.hpp"
+#include "libguard/guard_index.hpp"
+#include "libguard/guard_interface.hpp"
+#include "libguard/guard_journal.hpp"
+#include "libguard/guard_migrate.hpp"
+#include "libguard/guard_scan.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <endian.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace fs = std::filesystem;
+using namespace openpower::guard;
+
+/**
+ * Partition sizes (number of record slots) and fill levels (percentage of
+ * used slots) to measure. Every 4th used slot is a resolved record.
+ */
+static const std::vector<int64_t> partitionSlots = {8, 64, 512, 4096};
+static const std::vector<int64_t> fillLevels = {0, 50, 100};
+static const std::vector<int64_t> usedFillLevels = {50, 100};
+static constexpr size_t resolvedEvery = 4;
+
+#ifdef PGUARD
+static constexpr size_t headerSize = 0;
+#else
+static constexpr size_t headerSize = 16;
+#endif
+
+/**
+ * @brief Return the unique core entity path for the given index
+ */
+static EntityPath corePath(size_t index)
+{
+    return EntityPath{0x26,
+                      0x01,
+                      0x00,
+                      0x02,
+                      0x00,
+                      0x05,
+                      static_cast<uint8_t>(index >> 8),
+                      0x23,
+                      static_cast<uint8_t>((index >> 4) & 0x0F),
+                      0x53,
+                      static_cast<uint8_t>((index >> 1) & 0x07),
+                      0x07,
+                      static_cast<uint8_t>(index & 0x01)};
+}
+
+/**
+ * @class GuardPartition
+ *
+ * Synthetic guard partition file in a temporary directory, which is
+ * restored to the initial content after every measured operation.
+ */
+class GuardPartition
+{
+  public:
+    GuardPartition(size_t slots, size_t fillLevel)
+    {
+        char dirTemplate[] = "/tmp/GuardBench.XXXXXX";
+        dir = mkdtemp(dirTemplate);
+        file = dir / "GUARD";
+
+        image.assign(headerSize + slots * sizeof(GuardRecord), 0xFF);
+#ifndef PGUARD
+        memcpy(image.data(), GUARD_MAGIC, strlen(GUARD_MAGIC));
+        image[8] = CURRENT_GARD_VERSION_LAYOUT;
+#endif
+        used = slots * fillLevel / 100;
+        for (size_t i = 0; i < used; i++)
+        {
+            GuardRecord record;
+            memset(&record, 0, sizeof(record));
+            record.recordId = (i % resolvedEvery == resolvedEvery - 1)
+                                  ? GUARD_RESOLVED
+                                  : htobe32(i + 1);
+            record.targetId = corePath(i);
+            record.elogId = htobe32(0x90000000 + i);
+            record.errType = GARD_Predictive;
+            memcpy(image.data() + headerSize + i * sizeof(record), &record,
+                   sizeof(record));
+        }
+        restore();
+        utest::setGuardFile(file);
+    }
+
+    ~GuardPartition()
+    {
+        fs::remove_all(dir);
+    }
+
+    /**
+     * @brief Write the initial content to the partition file
+     */
+    void restore()
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(image.data()), image.size());
+    }
+
+    /**
+     * @brief Return the last unresolved record index, -1 if none
+     */
+    int lastLiveRecord() const
+    {
+        for (int i = static_cast<int>(used) - 1; i >= 0; i--)
+        {
+            if (i % resolvedEvery != resolvedEvery - 1)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Return the partition file
+     */
+    const fs::path& path() const
+    {
+        return file;
+    }
+
+    size_t used = 0;
+
+  private:
+    fs::path dir;
+    fs::path file;
+    std::vector<uint8_t> image;
+};
+
+static void setCounters(benchmark::State& state)
+{
+    state.counters["slots"] = state.range(0);
+    state.counters["fill"] = state.range(1);
+}
+
+static void BM_Create(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), state.range(1));
+    // Full partition without resolved slots has no space for a record
+    if (partition.used == static_cast<size_t>(state.range(0)) &&
+        partition.used < resolvedEvery)
+    {
+        state.SkipWithError("No space to create a record");
+        return;
+    }
+    EntityPath entityPath = corePath(partition.used);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(create(entityPath, 0, GARD_Predictive));
+        state.PauseTiming();
+        partition.restore();
+        state.ResumeTiming();
+    }
+    setCounters(state);
+}
+
+static void BM_GetAll(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), state.range(1));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(getAll());
+    }
+    state.SetItemsProcessed(state.iterations() * partition.used);
+    setCounters(state);
+}
+
+/**
+ * Listing the summaries of the records into an arena which is released
+ * after every list, compare with BM_GetAll
+ */
+static void BM_GetAllSummaries(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), state.range(1));
+    std::vector<uint8_t> buf(state.range(0) * sizeof(GuardRecordSummary) * 2);
+    std::pmr::monotonic_buffer_resource arena(buf.data(), buf.size());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(getAllSummaries(false, &arena));
+        arena.release();
+    }
+    state.SetItemsProcessed(state.iterations() * partition.used);
+    setCounters(state);
+}
+
+static void BM_ClearById(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), state.range(1));
+    int last = partition.lastLiveRecord();
+    for (auto _ : state)
+    {
+        clear(static_cast<uint32_t>(last + 1), true);
+        state.PauseTiming();
+        partition.restore();
+        state.ResumeTiming();
+    }
+    setCounters(state);
+}
+
+static void BM_ClearByPath(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), state.range(1));
+    EntityPath entityPath = corePath(partition.lastLiveRecord());
+    for (auto _ : state)
+    {
+        clear(entityPath, true);
+        state.PauseTiming();
+        partition.restore();
+        state.ResumeTiming();
+    }
+    setCounters(state);
+}
+
+static void BM_InvalidateAll(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), state.range(1));
+    for (auto _ : state)
+    {
+        invalidateAll();
+        state.PauseTiming();
+        partition.restore();
+        state.ResumeTiming();
+    }
+    setCounters(state);
+}
+
+static void BM_ClearAll(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), state.range(1));
+    for (auto _ : state)
+    {
+        clearAll();
+        state.PauseTiming();
+        partition.restore();
+        state.ResumeTiming();
+    }
+    setCounters(state);
+}
+
+BENCHMARK(BM_Create)->ArgsProduct({partitionSlots, fillLevels});
+BENCHMARK(BM_GetAll)->ArgsProduct({partitionSlots, fillLevels});
+BENCHMARK(BM_GetAllSummaries)->ArgsProduct({partitionSlots, fillLevels});
+BENCHMARK(BM_ClearById)->ArgsProduct({partitionSlots, usedFillLevels});
+BENCHMARK(BM_ClearByPath)->ArgsProduct({partitionSlots, usedFillLevels});
+BENCHMARK(BM_InvalidateAll)->ArgsProduct({partitionSlots, fillLevels});
+BENCHMARK(BM_ClearAll)->ArgsProduct({partitionSlots, fillLevels});
+
+/**
+ * Building the index of the hot fields of the records, see GuardIndex
+ */
+static void BM_IndexBuild(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), state.range(1));
+    for (auto _ : state)
+    {
+        GuardIndex index;
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * partition.used);
+    setCounters(state);
+}
+
+/**
+ * Counting and filtering the records of the full partition with the index
+ * built already, compare with BM_GetAll
+ */
+static void BM_IndexFilter(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), 100);
+    GuardIndex index;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(index.countUnresolved(true));
+        benchmark::DoNotOptimize(index.filterByType(GARD_Predictive));
+    }
+    state.SetItemsProcessed(state.iterations() * partition.used);
+    state.counters["slots"] = state.range(0);
+}
+
+/**
+ * Looking up the last live record of the full partition by its target with
+ * the index built already, which reads only the matching slot
+ */
+static void BM_IndexFind(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), 100);
+    GuardIndex index;
+    EntityPath entityPath = corePath(partition.lastLiveRecord());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(index.find(entityPath));
+    }
+    state.counters["slots"] = state.range(0);
+}
+
+BENCHMARK(BM_IndexBuild)->ArgsProduct({partitionSlots, fillLevels});
+BENCHMARK(BM_IndexFilter)->ArgsProduct({partitionSlots});
+BENCHMARK(BM_IndexFind)->ArgsProduct({partitionSlots});
+
+/**
+ * Checksum of all the record slots of the partition, the cost of checking
+ * a full partition with the record checksum
+ */
+static void BM_Crc32cPartition(benchmark::State& state)
+{
+    std::vector<uint8_t> slots(state.range(0) * sizeof(GuardRecord), 0x5A);
+    for (auto _ : state)
+    {
+        for (size_t pos = 0; pos < slots.size(); pos += sizeof(GuardRecord))
+        {
+            benchmark::DoNotOptimize(
+                crc32c(slots.data() + pos, sizeof(GuardRecord)));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * slots.size());
+    state.counters["slots"] = state.range(0);
+}
+
+BENCHMARK(BM_Crc32cPartition)->ArgsProduct({partitionSlots});
+
+/**
+ * Classifying all the record slots of the partition image against a key
+ * which matches every third slot, with the vector instructions (0) or the
+ * portable loop (1)
+ */
+static void BM_ScanSlots(benchmark::State& state)
+{
+    size_t count = state.range(0);
+    std::vector<uint8_t> slots(count * sizeof(GuardRecord));
+    EntityPath key = corePath(0);
+    for (size_t pos = 0; pos < count; pos++)
+    {
+        GuardRecord record;
+        memset(&record, 0, sizeof(record));
+        record.recordId = htobe32(pos + 1);
+        record.targetId = corePath(pos % 3);
+        memcpy(slots.data() + pos * sizeof(record), &record, sizeof(record));
+    }
+
+    std::vector<uint8_t> classes(count);
+    auto scan = state.range(1) ? scanSlotsPortable : scanSlots;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(scan(slots.data(), count, sizeof(GuardRecord),
+                                      sizeof(GuardRecord), &key,
+                                      classes.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * slots.size());
+    state.counters["slots"] = state.range(0);
+}
+
+BENCHMARK(BM_ScanSlots)->ArgsProduct({partitionSlots, {0, 1}});
+
+/**
+ * Opening the journal with the given number of entries, which are not
+ * written to the 4096 slot partition yet
+ */
+static void BM_JournalReplay(benchmark::State& state)
+{
+    GuardPartition partition(4096, 0);
+    fs::path journalFile = partition.path().string() + ".journal";
+    std::vector<char> journal;
+    {
+        JournaledGuard journaled(journalFile, SIZE_MAX);
+        for (int64_t i = 0; i < state.range(0); i++)
+        {
+            journaled.create(corePath(i), 0, GARD_Predictive);
+        }
+        std::ifstream in(journalFile, std::ios::binary);
+        journal.assign(std::istreambuf_iterator<char>(in), {});
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        partition.restore();
+        {
+            std::ofstream out(journalFile, std::ios::binary | std::ios::trunc);
+            out.write(journal.data(), journal.size());
+        }
+        state.ResumeTiming();
+
+        auto journaled = std::make_unique<JournaledGuard>(journalFile,
+                                                          SIZE_MAX);
+        state.PauseTiming();
+        journaled.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["entries"] = state.range(0);
+}
+
+BENCHMARK(BM_JournalReplay)->RangeMultiplier(8)->Range(1, 512);
+
+/**
+ * Migrating the full partition to the standard (0) or the PGUARD (1)
+ * layout, as done during the code update. The target has the same number
+ * of slots.
+ */
+static void BM_Migrate(benchmark::State& state)
+{
+    GuardPartition partition(state.range(0), 100);
+    GuardLayout layout = state.range(1) ? GuardLayout::PGuard
+                                        : GuardLayout::Standard;
+    size_t targetSize =
+        state.range(1)
+            ? RecordCodec<PGuardLayout>::offset(state.range(0))
+            : RecordCodec<StandardLayout>::offset(state.range(0));
+    fs::path target = partition.path().string() + ".migrated";
+    {
+        std::ofstream out(target, std::ios::binary | std::ios::trunc);
+        std::vector<char> erased(targetSize, '\xff');
+        out.write(erased.data(), erased.size());
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(migrate(partition.path(), target, layout));
+    }
+    state.SetItemsProcessed(state.iterations() * partition.used);
+    state.counters["slots"] = state.range(0);
+}
+
+BENCHMARK(BM_Migrate)
+    ->ArgsProduct({partitionSlots, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+#ifndef DEV_TREE
+/**
+ * The physical path conversions are measured against the built-in
+ * physical path list, see test/devtree_test for the device tree ones.
+ */
+static const std::vector<std::string> physicalPaths = {
+    "/sys-0", "/sys-0/node-0/proc-0/mc-0/mi-0/mcc-0",
+    "/sys-0/node-0/proc-3/pec-1/phb-2"};
+
+static void BM_GetEntityPath(benchmark::State& state)
+{
+    const std::string& physicalPath = physicalPaths[state.range(0)];
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(getEntityPath(physicalPath));
+    }
+}
+
+static void BM_GetPhysicalPath(benchmark::State& state)
+{
+    EntityPath entityPath = *getEntityPath(physicalPaths[state.range(0)]);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(getPhysicalPath(entityPath));
+    }
+}
+
+static void BM_ResolvePhysicalPaths(benchmark::State& state)
+{
+    std::vector<EntityPath> entityPaths;
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+        entityPaths.push_back(
+            *getEntityPath(physicalPaths[i % physicalPaths.size()]));
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(resolvePhysicalPaths(entityPaths));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_GetEntityPath)->DenseRange(0, physicalPaths.size() - 1);
+BENCHMARK(BM_GetPhysicalPath)->DenseRange(0, physicalPaths.size() - 1);
+BENCHMARK(BM_ResolvePhysicalPaths)->RangeMultiplier(8)->Range(1, 4096);
+#endif /* DEV_TREE */
+
+BENCHMARK_MAIN();
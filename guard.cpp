@@ -1,5 +1,8 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "libguard/guard_interface.hpp"
+#include "libguard/guard_migrate.hpp"
+#include "libguard/guard_stats.hpp"
+#include "libguard/guard_watch.hpp"
 #include "libguard/include/guard_record.hpp"
 
 #include <config.h>
@@ -20,7 +23,8 @@ void printHeader()
     std::cout << "Path" << std::endl;
 }
 
-void printRecord(const GuardRecord& record)
+void printRecord(const GuardRecord& record,
+                 const std::optional<std::string>& physicalPath)
 {
     std::cout << std::right << "0x" << std::hex << std::setw(8)
               << std::setfill('0') << record.recordId;
@@ -34,7 +38,6 @@ void printRecord(const GuardRecord& record)
               << guardReasonToStr(record.errType);
 
     std::cout << " | ";
-    std::optional<std::string> physicalPath = getPhysicalPath(record.targetId);
     if (!physicalPath)
     {
         std::cout << "Unknown ";
@@ -46,6 +49,33 @@ void printRecord(const GuardRecord& record)
     std::cout << std::endl;
 }
 
+/**
+ * @brief Print the given records along with the header
+ *
+ * The physical path of all the records are resolved together instead
+ * of one lookup per record.
+ *
+ * @param[in] records the records to print
+ *
+ * @return NULL
+ */
+void printRecords(const GuardRecords& records)
+{
+    std::vector<EntityPath> entityPaths;
+    entityPaths.reserve(records.size());
+    for (const auto& record : records)
+    {
+        entityPaths.push_back(record.targetId);
+    }
+    auto physicalPaths = resolvePhysicalPaths(entityPaths);
+
+    printHeader();
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        printRecord(records[i], physicalPaths[i]);
+    }
+}
+
 void guardList(bool displayResolved)
 {
     // Don't get ephemeral records because those type records are not intended
@@ -58,7 +88,7 @@ void guardList(bool displayResolved)
         return;
     }
 
-    bool isHeaderPrinted = false;
+    GuardRecords displayRecords;
     for (const auto& elem : records)
     {
         // To list resolved records as user wants to list resolved records
@@ -71,25 +101,21 @@ void guardList(bool displayResolved)
         {
             continue;
         }
-
-        // Don't print the header if already printed header since
-        // records mixed of resolved and unresolved records so if have
-        // only either one in retrieved records and user tried to see opposite
-        // one then we should not print header else user will get confused.
-        if (!isHeaderPrinted)
-        {
-            printHeader();
-            isHeaderPrinted = true;
-        }
-        printRecord(elem);
+        displayRecords.push_back(elem);
     }
 
-    if (!isHeaderPrinted)
+    // Don't print the header if there are no records to display since
+    // records mixed of resolved and unresolved records so if have
+    // only either one in retrieved records and user tried to see opposite
+    // one then we should not print header else user will get confused.
+    if (displayRecords.empty())
     {
         std::cout << "No "
                   << (displayResolved == true ? "resolved" : "unresolved")
                   << " records to display" << std::endl;
+        return;
     }
+    printRecords(displayRecords);
 }
 
 /**
@@ -108,26 +134,21 @@ void guardListEphemeralRecords()
         return;
     }
 
-    bool isHeaderPrinted = false;
+    GuardRecords ephemeralRecords;
     for (const auto& record : records)
     {
-        if (!isEphemeralType(record.errType))
-        {
-            continue;
-        }
-
-        if (!isHeaderPrinted)
+        if (isEphemeralType(record.errType))
         {
-            printHeader();
-            isHeaderPrinted = true;
+            ephemeralRecords.push_back(record);
         }
-        printRecord(record);
     }
 
-    if (!isHeaderPrinted)
+    if (ephemeralRecords.empty())
     {
         std::cout << "No ephemeral records to display" << std::endl;
+        return;
     }
+    printRecords(ephemeralRecords);
 }
 
 void guardDelete(const uint32_t recordId)
@@ -157,6 +178,109 @@ void guardCreate(const std::string& physicalPath)
     std::cout << "Success" << std::endl;
 }
 
+/**
+ * @brief Copy the guard records to the given file in the given layout
+ *
+ * @param[in] target GUARD file to write
+ * @param[in] layoutName layout of the target, standard or pguard
+ * @param[in] dropResolved do not copy the resolved records
+ *
+ * @return NULL
+ */
+void guardMigrate(const std::string& target, const std::string& layoutName,
+                  bool dropResolved)
+{
+    GuardLayout layout = (layoutName == "pguard") ? GuardLayout::PGuard
+                                                  : GuardLayout::Standard;
+    auto records = migrate(getGuardFilePath(), target, layout, dropResolved);
+    std::cout << "Migrated " << std::dec << records << " records to "
+              << target << std::endl;
+}
+
+/**
+ * @brief Print the guard record changes until the tool is stopped
+ *
+ * @return NULL
+ */
+void guardWatch()
+{
+    GuardWatcher watcher;
+    watcher.subscribe([](const GuardEvents& events) {
+        std::vector<EntityPath> entityPaths;
+        entityPaths.reserve(events.size());
+        for (const auto& event : events)
+        {
+            entityPaths.push_back(event.record.targetId);
+        }
+        auto physicalPaths = resolvePhysicalPaths(entityPaths);
+
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            std::cout << std::left << std::setfill(' ') << std::setw(12)
+                      << guardEventToStr(events[i].type) << " | ";
+            printRecord(events[i].record, physicalPaths[i]);
+        }
+    });
+
+    std::cout << std::left << std::setfill(' ') << std::setw(12) << "Event"
+              << " | ";
+    printHeader();
+    while (true)
+    {
+        watcher.wait(-1);
+    }
+}
+
+/**
+ * @brief Print the libguard counters of this process
+ *
+ * @return NULL
+ */
+void printStats()
+{
+    auto guardStats = getStats();
+    std::cout << std::dec << "opens: " << guardStats.opens << std::endl;
+    std::cout << "reads: " << guardStats.reads << std::endl;
+    std::cout << "writes: " << guardStats.writes << std::endl;
+    std::cout << "bytes read: " << guardStats.bytesRead << std::endl;
+    std::cout << "bytes written: " << guardStats.bytesWritten << std::endl;
+    std::cout << "fsyncs: " << guardStats.fsyncs << std::endl;
+    std::cout << "records scanned: " << guardStats.recordsScanned << std::endl;
+    std::cout << "devtree traversals: " << guardStats.devTreeTraversals
+              << std::endl;
+    std::cout << "checksum errors: " << guardStats.checksumErrors << std::endl;
+    std::cout << "journal drops: " << guardStats.journalDrops << std::endl;
+
+    for (size_t api = 0; api < guardStats.latency.size(); api++)
+    {
+        const auto& latency = guardStats.latency[api];
+        if (latency.count == 0)
+        {
+            continue;
+        }
+        std::cout << stats::apiToStr(static_cast<stats::Api>(api))
+                  << ": calls " << latency.count << " total "
+                  << latency.totalNs / 1000 << "us max "
+                  << latency.maxNs / 1000 << "us" << std::endl;
+        for (size_t bucket = 0; bucket < latency.buckets.size(); bucket++)
+        {
+            if (latency.buckets[bucket] == 0)
+            {
+                continue;
+            }
+            if (bucket == latency.buckets.size() - 1)
+            {
+                std::cout << "  >=" << (1ULL << (bucket - 1)) << "us: ";
+            }
+            else
+            {
+                std::cout << "  <" << (1ULL << bucket) << "us: ";
+            }
+            std::cout << latency.buckets[bucket] << std::endl;
+        }
+    }
+}
+
 static void exitWithError(const std::string& help, const char* err)
 {
     std::cerr << "ERROR: " << err << std::endl << help << std::endl;
@@ -176,6 +300,11 @@ int main(int argc, char** argv)
         bool listEphemeralRecords = false;
         bool invalidateAll = false;
         bool gversion = false;
+        bool showStats = false;
+        bool watch = false;
+        std::optional<std::string> migrateTarget;
+        std::string layoutName = "standard";
+        bool dropResolved = false;
 
         app.set_help_flag("-h, --help", "Guard CLI tool options");
         app.add_option("-c, --create", createGuardStr,
@@ -197,6 +326,18 @@ int main(int argc, char** argv)
                      "resources")
             ->group("");
         app.add_flag("-v, --version", gversion, "Version of GUARD tool");
+        app.add_flag("-w, --watch", watch,
+                     "Print the Guard record changes as they happen");
+        app.add_flag("-s, --stats", showStats,
+                     "Print the I/O counters and latency of the operation");
+        app.add_option("-m, --migrate", migrateTarget,
+                       "Copy the Guard records to the given GUARD file, "
+                       "in the layout of --layout");
+        app.add_option("--layout", layoutName,
+                       "Layout to migrate to, standard or pguard")
+            ->check(CLI::IsMember({"standard", "pguard"}));
+        app.add_flag("--drop-resolved", dropResolved,
+                     "Do not migrate the resolved Guard records");
 
         CLI11_PARSE(app, argc, argv);
 
@@ -230,15 +371,28 @@ int main(int argc, char** argv)
         {
             guardInvalidateAll();
         }
+        else if (watch)
+        {
+            guardWatch();
+        }
+        else if (migrateTarget)
+        {
+            guardMigrate(*migrateTarget, layoutName, dropResolved);
+        }
         else if (gversion)
         {
             std::cout << "Guard tool " << GUARD_VERSION << std::endl;
         }
-        else
+        else if (!showStats)
         {
             exitWithError(app.help("", CLI::AppFormatMode::All),
                           "Invalid option");
         }
+
+        if (showStats)
+        {
+            printStats();
+        }
     }
     catch (const std::exception& ex)
     {
@@ -1,11 +1,29 @@
 // SPDX-License-Identifier: Apache-2.0
+#include "config.h"
+
 #include "phal_devtree.hpp"
 
 #include "guard_log.hpp"
+#include "guard_stats.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "attributes_info.H"
 
@@ -24,326 +42,731 @@ namespace log = openpower::guard::log;
  * The value for constexpr defined based on pdbg_target_traverse function usage.
  */
 constexpr int continueTgtTraversal = 0;
-constexpr int requireAttrFound = 1;
-constexpr int requireAttrNotFound = 2;
 
 /**
- * Used to store|retrieve physical path in binary format inside pdbg
- * callback functions to get value from device tree
+ * Physical path of a device tree target in both string and binary format
  */
-static ATTR_PHYS_BIN_PATH_Type g_physBinaryPath;
+struct PathIndexEntry
+{
+    ATTR_PHYS_DEV_PATH_Type physStringPath; ///< ATTR_PHYS_DEV_PATH value
+    EntityPath entityPath;                  ///< ATTR_PHYS_BIN_PATH value
+    uint8_t hasFruVpd;                      ///< fruVpd is valid if non-zero
+    FruVpd fruVpd;                          ///< VPD of the containing FRU
+};
 
 /**
- * Used to store|retrieve physical path in string format inside pdbg
- * callback functions to get value from device tree
+ * Bidirectional index between ATTR_PHYS_DEV_PATH and ATTR_PHYS_BIN_PATH
+ * of all the device tree targets.
+ *
+ * The index is built by a single device tree traversal or loaded from the
+ * index cache file so, the physical path conversions are hash lookups
+ * instead of a traversal per lookup. The string keys are views into the
+ * entries, so the entries must not change once the lookup tables are built.
  */
-static ATTR_PHYS_DEV_PATH_Type g_physStringPath;
-
-void initPHAL()
+struct PathIndex
 {
-    // Set log level to info
-    pdbg_set_loglevel(PDBG_ERROR);
+    PathIndex() = default;
+    PathIndex(const PathIndex&) = delete;
+    PathIndex& operator=(const PathIndex&) = delete;
 
-    /**
-     * Passing fdt argument as NULL so, pdbg will use PDBG_DTB environment
-     * variable to get system device tree.
-     */
-    if (!pdbg_targets_init(NULL))
+    ~PathIndex()
     {
-        log::guard_log(GUARD_ERROR, "pdbg_targets_init failed");
-        throw std::runtime_error("pdbg target initialization failed");
+        if (cacheMapping != MAP_FAILED)
+        {
+            munmap(cacheMapping, cacheMappingSize);
+        }
     }
-}
+
+    /**
+     * The index entries, points either to the entries collected from
+     * the device tree or to the entries of the mapped index cache file.
+     */
+    const PathIndexEntry* entries = nullptr;
+    size_t size = 0;
+
+    std::vector<PathIndexEntry> collectedEntries;
+    void* cacheMapping = MAP_FAILED;
+    size_t cacheMappingSize = 0;
+
+    std::unordered_map<std::string_view, size_t> byPhysStringPath;
+    std::unordered_map<EntityPath, size_t, EntityPathHash> byEntityPath;
+};
+
+/**
+ * Header of the physical path index cache file, followed by the index
+ * entries. The DTB (PDBG_DTB) identity is stored to invalidate the cache
+ * when the device tree is changed.
+ */
+struct PathIndexCacheHeader
+{
+    char magic[8];         ///< "GUARDIDX"
+    uint32_t version;      ///< Cache file format version
+    uint32_t entrySize;    ///< Size of the each index entry
+    uint64_t dtbSize;      ///< DTB file size
+    int64_t dtbMtimeSec;   ///< DTB last modification time in seconds
+    int64_t dtbMtimeNsec;  ///< and nanoseconds
+    uint64_t dtbDevice;    ///< DTB file device id
+    uint64_t dtbInode;     ///< DTB file inode number
+    uint64_t entriesCount; ///< Number of index entries
+};
+
+constexpr char pathIndexCacheMagic[8] = {'G', 'U', 'A', 'R',
+                                         'D', 'I', 'D', 'X'};
+constexpr uint32_t pathIndexCacheVersion = 2;
+
+/**
+ * The published physical path index. The index is never modified once
+ * published so, lookups just take a reference to it and can run from
+ * many threads in parallel. g_pathIndexMutex serializes the device tree
+ * traversal which is used to build the index.
+ */
+static std::shared_ptr<const PathIndex> g_pathIndex;
+static std::mutex g_pathIndexMutex;
 
 /**
- * @brief To get physical path binary value from device tree
+ * @brief To add physical path of the device tree target into the index
  *
- * pdbg callback function used to get physical path binary value from
- * device tree by using physical path becuase guard doesn't know target
- * class name for given physical path.
+ * pdbg callback function used to collect physical path string and
+ * binary value of every target which are having both attributes.
  *
  * @param[in] target current target
- * @param[in] priv private data assoicated with callback function. not used
- * @return 0 to continue traverse, non-zero to stop traverse
+ * @param[in] priv PathIndex to add the target physical path
+ * @return 0 to continue traverse
  */
-int pdbgCallbackToGetPhysicaBinaryPath(struct pdbg_target* target,
-                                       void* /*priv - unused*/)
+int pdbgCallbackToBuildPathIndex(struct pdbg_target* target, void* priv)
 {
-    ATTR_PHYS_DEV_PATH_Type physStringPath;
-    if (DT_GET_PROP(ATTR_PHYS_DEV_PATH, target, physStringPath))
+    auto* pathIndex = static_cast<PathIndex*>(priv);
+
+    ATTR_PHYS_BIN_PATH_Type physBinaryPath;
+    /**
+     * TODO: Issue: phal/pdata#16
+     * Should not use direct pdbg api to read attribute. Need to use
+     * DT_GET_PROP but, libdt-api printing "pdbg_target_get_attribute failed"
+     * for failure case and in guard case it expected trace because, doing
+     * target iteration to get actual ATTR_PHYS_BIN_PATH value. So, Due to
+     * this error trace user will get confusion while listing guard records.
+     * Hence using pdbg api to avoid trace until libdt-api providing log
+     * level setup.
+     */
+    if (!pdbg_target_get_attribute(
+            target, "ATTR_PHYS_BIN_PATH",
+            std::stoi(dtAttr::fapi2::ATTR_PHYS_BIN_PATH_Spec),
+            dtAttr::fapi2::ATTR_PHYS_BIN_PATH_ElementCount, physBinaryPath))
     {
         /**
-         * Continue target traversal if ATTR_PHYS_DEV_PATH
+         * Continue target traversal if ATTR_PHYS_BIN_PATH
          * attribute not found.
          */
         return continueTgtTraversal;
     }
 
-    if (std::strcmp(g_physStringPath, physStringPath) != 0)
+    PathIndexEntry entry;
+    std::memset(entry.physStringPath, 0, sizeof(entry.physStringPath));
+    if (DT_GET_PROP(ATTR_PHYS_DEV_PATH, target, entry.physStringPath))
     {
         /**
          * Continue target traversal if ATTR_PHYS_DEV_PATH
-         * attribute value is not matched with given physical path value.
+         * attribute not found within ATTR_PHYS_BIN_PATH attribute
+         * target property list
          */
         return continueTgtTraversal;
     }
-    else
-    {
-        /**
-         * The ATTR_PHYS_DEV_PATH attribute value is matched with given
-         * physical path value. so, getting physical path binary value
-         * by using ATTR_PHYS_BIN_PATH attribute from same target property
-         * list.
-         */
+    // Make sure the physical path is always NULL terminated
+    entry.physStringPath[sizeof(entry.physStringPath) - 1] = '\0';
 
-        // Clear old value in g_physBinaryPath
-        std::memset(g_physBinaryPath, 0, sizeof(g_physBinaryPath));
+    try
+    {
+        entry.entityPath = EntityPath(
+            reinterpret_cast<uint8_t*>(physBinaryPath), sizeof(physBinaryPath));
+    }
+    catch (const InvalidEntityPath&)
+    {
+        GUARD_LOG(GUARD_ERROR,
+                  "Invalid physical path binary value for %s",
+                  entry.physStringPath);
+        return continueTgtTraversal;
+    }
 
-        if (DT_GET_PROP(ATTR_PHYS_BIN_PATH, target, g_physBinaryPath))
-        {
-            /**
-             * Stopping the target target traversal if ATTR_PHYS_BIN_PATH
-             * attribute not found within ATTR_PHYS_DEV_PATH attribute
-             * target property list
-             */
-            return requireAttrNotFound;
-        }
-        else
-        {
-            /**
-             * Found the physical binary value from device tree by using
-             * given physical path value.
-             */
-            return requireAttrFound;
-        }
+    // Only the FRU targets are having VPD attributes
+    entry.hasFruVpd = 0;
+    entry.fruVpd = {};
+    ATTR_SERIAL_NUMBER_Type serialNum;
+    if (pdbg_target_get_attribute(
+            target, "ATTR_SERIAL_NUMBER",
+            std::stoi(dtAttr::fapi2::ATTR_SERIAL_NUMBER_Spec),
+            dtAttr::fapi2::ATTR_SERIAL_NUMBER_ElementCount, serialNum))
+    {
+        std::memcpy(entry.fruVpd.serialNum.data(), serialNum,
+                    std::min(sizeof(serialNum),
+                             entry.fruVpd.serialNum.size()));
+        entry.hasFruVpd = 1;
+    }
+    ATTR_PART_NUMBER_Type partNum;
+    if (pdbg_target_get_attribute(
+            target, "ATTR_PART_NUMBER",
+            std::stoi(dtAttr::fapi2::ATTR_PART_NUMBER_Spec),
+            dtAttr::fapi2::ATTR_PART_NUMBER_ElementCount, partNum))
+    {
+        std::memcpy(entry.fruVpd.partNum.data(), partNum,
+                    std::min(sizeof(partNum),
+                             entry.fruVpd.partNum.size()));
+        entry.hasFruVpd = 1;
     }
 
-    return requireAttrNotFound;
+    pathIndex->collectedEntries.push_back(entry);
+    return continueTgtTraversal;
 }
 
-std::optional<EntityPath>
-    getEntityPathFromDevTree(const std::string& physicalPath)
+/**
+ * @brief To fill the lookup tables of the physical path index
+ *
+ * @param[in] pathIndex the index to fill lookup tables from its entries
+ * @return void
+ */
+static void fillPathIndexLookup(PathIndex& pathIndex)
 {
     /**
-     * Make sure physicalPath is in lower case because,
-     * in device tree physical path is in lower case
+     * Keep the first target if the same physical path is found more than
+     * once, the same as the first match of a device tree traversal.
      */
-    std::string l_physicalPath(physicalPath);
-    std::transform(l_physicalPath.begin(), l_physicalPath.end(),
-                   l_physicalPath.begin(), ::tolower);
-
-    /**
-     * Removing "/" as prefix in given path if found to match with
-     * device tree value
-     */
-    if (!l_physicalPath.compare(0, 1, "/"))
+    pathIndex.byPhysStringPath.reserve(pathIndex.size);
+    pathIndex.byEntityPath.reserve(pathIndex.size);
+    for (size_t i = 0; i < pathIndex.size; i++)
     {
-        l_physicalPath.erase(0, 1);
+        const auto& entry = pathIndex.entries[i];
+        pathIndex.byPhysStringPath.emplace(
+            std::string_view(entry.physStringPath,
+                             strnlen(entry.physStringPath,
+                                     sizeof(entry.physStringPath))),
+            i);
+        pathIndex.byEntityPath.emplace(entry.entityPath, i);
     }
+}
 
-    /**
-     * Adding "physical:" as prefix to given path to match with
-     * device tree value if not given
-     */
-    if (l_physicalPath.find("physical:", 0, 9) == std::string::npos)
+/**
+ * @brief To fill the FRU VPD of the targets which are not FRU
+ *
+ * The targets which are not FRU (e.g. core) are using the VPD of the
+ * FRU containing them so, take the VPD from the nearest parent target
+ * which is having VPD.
+ *
+ * @param[in] pathIndex the index to fill the FRU VPD
+ * @return void
+ */
+static void inheritFruVpd(PathIndex& pathIndex)
+{
+    for (auto& entry : pathIndex.collectedEntries)
     {
-        l_physicalPath.insert(0, "physical:");
+        EntityPath parentPath = entry.entityPath;
+        while (!entry.hasFruVpd && ((parentPath.type_size & 0x0F) > 1))
+        {
+            parentPath.type_size--;
+            auto parent = pathIndex.byEntityPath.find(parentPath);
+            if ((parent != pathIndex.byEntityPath.end()) &&
+                pathIndex.entries[parent->second].hasFruVpd)
+            {
+                entry.hasFruVpd = 1;
+                entry.fruVpd = pathIndex.entries[parent->second].fruVpd;
+            }
+        }
     }
+}
 
-    if ((l_physicalPath.length() - 1 /* To include NULL terminator */) >
-        sizeof(g_physStringPath))
+/**
+ * @brief To build the physical path index from device tree
+ *
+ * Traverse the device tree once to collect the physical path string and
+ * binary value of all the targets and fill the lookup tables.
+ *
+ * @return the built physical path index
+ *
+ * @note The caller must hold g_pathIndexMutex
+ */
+static std::shared_ptr<PathIndex> buildPathIndex()
+{
+    auto pathIndex = std::make_shared<PathIndex>();
+
+    if (sizeof(EntityPath) != sizeof(ATTR_PHYS_BIN_PATH_Type))
     {
-        log::guard_log(
+        GUARD_LOG(
             GUARD_ERROR,
-            "Physical path size mismatch with given[%zu] and max size[%zu]",
-            sizeof(g_physStringPath), (l_physicalPath.length() - 1));
-        return std::nullopt;
+            "Physical path binary size mismatch with devtree[%zu] guard[%zu]",
+            sizeof(ATTR_PHYS_BIN_PATH_Type), sizeof(EntityPath));
+        return pathIndex;
     }
 
-    /**
-     * The callback function (pdbgCallbackToGetPhysicaBinaryPath) will use
-     * the given physical path from g_physStringPath variable.
-     * so, clear old value in g_physStringPath
-     */
-    std::memset(g_physStringPath, 0, sizeof(g_physStringPath));
+    stats::add(stats::counters.devTreeTraversals);
+    pdbg_target_traverse(
+        nullptr /* Passing NULL to start target traversal from root */,
+        pdbgCallbackToBuildPathIndex,
+        pathIndex.get() /* Index to fill with the target physical path */);
 
-    /**
-     * The caller given value of physical path will be below format if not
-     * in device tree format to get raw data of physical path.
-     * E.g: physical:sys-0/node-0/proc-0
-     */
-    std::strncpy(g_physStringPath, l_physicalPath.c_str(),
-                 sizeof(g_physStringPath) - 1);
+    pathIndex->entries = pathIndex->collectedEntries.data();
+    pathIndex->size = pathIndex->collectedEntries.size();
+    fillPathIndexLookup(*pathIndex);
+    inheritFruVpd(*pathIndex);
 
-    int ret = pdbg_target_traverse(
-        nullptr /* Passing NULL to start target traversal from root */,
-        pdbgCallbackToGetPhysicaBinaryPath,
-        nullptr /* No application private data, so passing NULL */);
-    if (ret == 0)
+    GUARD_LOG(GUARD_INFO, "Device tree physical path index size: %zu",
+              pathIndex->size);
+    return pathIndex;
+}
+
+/**
+ * @brief To get the identity of the device tree which is used by pdbg
+ *
+ * @param[out] header index cache header to fill the DTB identity
+ * @return true if the index cache is enabled and the DTB identity
+ *         is found else false
+ */
+static bool getDtbIdentity(PathIndexCacheHeader& header)
+{
+    if (std::string_view(DEVTREE_CACHE_PATH).empty())
     {
-        log::guard_log(
-            GUARD_ERROR,
-            "Given physical path not found in power system device tree");
-        return std::nullopt;
+        return false;
     }
-    else if (ret == requireAttrNotFound)
+
+    const char* dtbPath = std::getenv("PDBG_DTB");
+    struct stat dtbStat;
+    if ((dtbPath == nullptr) || (stat(dtbPath, &dtbStat) != 0))
     {
-        log::guard_log(
-            GUARD_ERROR,
-            "Binary value for given physical path is not found in device tree");
-        return std::nullopt;
+        GUARD_LOG(GUARD_INFO, "PDBG_DTB is not found, not using the "
+                              "device tree physical path index cache");
+        return false;
     }
 
-    if (sizeof(EntityPath) < sizeof(g_physBinaryPath))
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, pathIndexCacheMagic, sizeof(header.magic));
+    header.version = pathIndexCacheVersion;
+    header.entrySize = sizeof(PathIndexEntry);
+    header.dtbSize = dtbStat.st_size;
+    header.dtbMtimeSec = dtbStat.st_mtim.tv_sec;
+    header.dtbMtimeNsec = dtbStat.st_mtim.tv_nsec;
+    header.dtbDevice = dtbStat.st_dev;
+    header.dtbInode = dtbStat.st_ino;
+    return true;
+}
+
+/**
+ * @brief To load the physical path index from the index cache file
+ *
+ * The cache file is memory mapped and used as it is if it was written
+ * for the same device tree (PDBG_DTB) which is in use.
+ *
+ * @return the loaded physical path index or nullptr if the cache is
+ *         disabled, not found or stale
+ */
+static std::shared_ptr<PathIndex> loadPathIndexCache()
+{
+    PathIndexCacheHeader dtbIdentity;
+    if (!getDtbIdentity(dtbIdentity))
     {
-        log::guard_log(
-            GUARD_ERROR,
-            "Physical path binary size mismatch with devtree[%zu] guard[%zu]",
-            sizeof(g_physBinaryPath), sizeof(EntityPath));
-        return std::nullopt;
+        return nullptr;
     }
 
-    return EntityPath(reinterpret_cast<uint8_t*>(g_physBinaryPath),
-                      sizeof(g_physBinaryPath));
+    int fd = open(DEVTREE_CACHE_PATH, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat cacheStat;
+    if ((fstat(fd, &cacheStat) != 0) ||
+        (static_cast<size_t>(cacheStat.st_size) < sizeof(dtbIdentity)))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    auto pathIndex = std::make_shared<PathIndex>();
+    pathIndex->cacheMappingSize = cacheStat.st_size;
+    pathIndex->cacheMapping = mmap(nullptr, pathIndex->cacheMappingSize,
+                                   PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pathIndex->cacheMapping == MAP_FAILED)
+    {
+        GUARD_LOG(GUARD_ERROR, "Failed to map the index cache file %s",
+                  DEVTREE_CACHE_PATH);
+        return nullptr;
+    }
+
+    const auto* header =
+        static_cast<const PathIndexCacheHeader*>(pathIndex->cacheMapping);
+    size_t maxEntries = (pathIndex->cacheMappingSize - sizeof(*header)) /
+                        sizeof(PathIndexEntry);
+    if ((std::memcmp(header, &dtbIdentity,
+                     offsetof(PathIndexCacheHeader, entriesCount)) != 0) ||
+        (header->entriesCount > maxEntries) ||
+        (pathIndex->cacheMappingSize !=
+         sizeof(*header) + header->entriesCount * sizeof(PathIndexEntry)))
+    {
+        GUARD_LOG(GUARD_INFO, "Ignoring the stale device tree physical "
+                              "path index cache");
+        return nullptr;
+    }
+
+    pathIndex->entries = reinterpret_cast<const PathIndexEntry*>(
+        static_cast<const char*>(pathIndex->cacheMapping) + sizeof(*header));
+    pathIndex->size = header->entriesCount;
+    fillPathIndexLookup(*pathIndex);
+
+    GUARD_LOG(GUARD_INFO, "Loaded device tree physical path index "
+                          "cache, index size: %zu",
+              pathIndex->size);
+    return pathIndex;
 }
 
 /**
- * @brief To get physical path from device tree
+ * @brief To store the physical path index into the index cache file
  *
- * pdbg callback function to get physical path from device tree
- * by using entity path raw data becuase guard doesn't know target
- * class name for given entity path
+ * The cache file is replaced atomically so, the other processes will
+ * either find the old or the new index cache.
  *
- * @param[in] target current target
- * @param[in] priv private data assoicated with callback function. not used
- * @return 0 to continue traverse, non-zero to stop traverse
+ * @param[in] dtbIdentity the identity of the device tree which is used
+ *                        to build the index
+ * @param[in] pathIndex the index to store
+ * @return void
  */
-int pdbgCallbackToGetPhysicalPath(struct pdbg_target* target,
-                                  void* /*priv - unused*/)
+static void storePathIndexCache(PathIndexCacheHeader dtbIdentity,
+                                const PathIndex& pathIndex)
 {
-    ATTR_PHYS_BIN_PATH_Type physBinaryPath;
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    fs::path cachePath(DEVTREE_CACHE_PATH);
+    fs::create_directories(cachePath.parent_path(), ec);
+
+    std::string tmpPath(cachePath.string() + ".XXXXXX");
+    int fd = mkostemp(tmpPath.data(), O_CLOEXEC);
+    if (fd < 0)
+    {
+        GUARD_LOG(GUARD_ERROR, "Failed to create the index cache file %s",
+                  tmpPath.c_str());
+        return;
+    }
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    dtbIdentity.entriesCount = pathIndex.size;
+    auto writeAll = [fd](const void* data, size_t len) {
+        const char* buf = static_cast<const char*>(data);
+        while (len > 0)
+        {
+            ssize_t ret = write(fd, buf, len);
+            if (ret < 0)
+            {
+                return false;
+            }
+            buf += ret;
+            len -= ret;
+        }
+        return true;
+    };
+    bool written =
+        writeAll(&dtbIdentity, sizeof(dtbIdentity)) &&
+        writeAll(pathIndex.entries, pathIndex.size * sizeof(PathIndexEntry));
+    close(fd);
+
+    if (!written || (rename(tmpPath.c_str(), DEVTREE_CACHE_PATH) != 0))
+    {
+        GUARD_LOG(GUARD_ERROR, "Failed to write the index cache file %s",
+                  DEVTREE_CACHE_PATH);
+        unlink(tmpPath.c_str());
+    }
+}
+
+/**
+ * @brief To init phal library and build the physical path index
+ *
+ * The index is loaded from the index cache file if it is valid for the
+ * device tree in use else, the index is built from the device tree.
+ *
+ * @return the physical path index
+ *
+ * @note The caller must hold g_pathIndexMutex
+ */
+static std::shared_ptr<const PathIndex> initPathIndex()
+{
+    // Set log level to info
+    pdbg_set_loglevel(PDBG_ERROR);
+
     /**
-     * TODO: Issue: phal/pdata#16
-     * Should not use direct pdbg api to read attribute. Need to use
-     * DT_GET_PROP but, libdt-api printing "pdbg_target_get_attribute failed"
-     * for failure case and in guard case it expected trace because, doing
-     * target iteration to get actual ATTR_PHYS_BIN_PATH value. So, Due to
-     * this error trace user will get confusion while listing guard records.
-     * Hence using pdbg api to avoid trace until libdt-api providing log
-     * level setup.
+     * The index cache contains all the device tree details which are
+     * required by libguard so, the device tree is not required to
+     * initialise if the index cache is valid for the device tree in use.
      */
-    if (!pdbg_target_get_attribute(
-            target, "ATTR_PHYS_BIN_PATH",
-            std::stoi(dtAttr::fapi2::ATTR_PHYS_BIN_PATH_Spec),
-            dtAttr::fapi2::ATTR_PHYS_BIN_PATH_ElementCount, physBinaryPath))
+    std::shared_ptr<const PathIndex> pathIndex = loadPathIndexCache();
+    if (pathIndex)
     {
-        /**
-         * Continue target traversal if ATTR_PHYS_BIN_PATH
-         * attribute not found.
-         */
-        return continueTgtTraversal;
+        return pathIndex;
+    }
+
+    // Get the DTB identity before pdbg start to use the DTB
+    PathIndexCacheHeader dtbIdentity;
+    bool useIndexCache = getDtbIdentity(dtbIdentity);
+
+    /**
+     * Passing fdt argument as NULL so, pdbg will use PDBG_DTB environment
+     * variable to get system device tree.
+     */
+    if (!pdbg_targets_init(NULL))
+    {
+        GUARD_LOG(GUARD_ERROR, "pdbg_targets_init failed");
+        throw std::runtime_error("pdbg target initialization failed");
     }
 
-    for (size_t i = 0; i < sizeof(g_physBinaryPath); i++)
+    auto builtPathIndex = buildPathIndex();
+    if (useIndexCache)
+    {
+        storePathIndexCache(dtbIdentity, *builtPathIndex);
+    }
+    return builtPathIndex;
+}
+
+/**
+ * Set by initPHALOnDemand() to init phal library during the first lookup
+ * else, the device tree is expected to be initialised by the caller.
+ */
+static std::atomic<bool> g_initPHALOnDemand{false};
+
+/**
+ * @brief To get the physical path index
+ *
+ * The index is built by initPHAL() or during the first lookup. The first
+ * lookup also init phal library if initPHALOnDemand() is used else, the
+ * device tree is expected to be initialised by the caller.
+ *
+ * Only one thread builds the index even if many threads are doing the
+ * first lookup in parallel, the other threads wait for that index.
+ *
+ * @return the physical path index, which stays valid for the caller
+ *         even if the index is rebuilt in parallel
+ */
+static std::shared_ptr<const PathIndex> getPathIndex()
+{
+    auto pathIndex = std::atomic_load(&g_pathIndex);
+    if (pathIndex)
     {
-        if (g_physBinaryPath[i] != physBinaryPath[i])
+        return pathIndex;
+    }
+
+    std::lock_guard<std::mutex> lock(g_pathIndexMutex);
+    pathIndex = std::atomic_load(&g_pathIndex);
+    if (!pathIndex)
+    {
+        if (g_initPHALOnDemand)
         {
-            /**
-             * Continue target traversal if ATTR_PHYS_BIN_PATH
-             * attribute value is not matched with given physical path
-             * binary format value.
-             */
-            return continueTgtTraversal;
+            pathIndex = initPathIndex();
         }
+        else
+        {
+            pathIndex = buildPathIndex();
+        }
+        std::atomic_store(&g_pathIndex, pathIndex);
     }
+    return pathIndex;
+}
+
+void initPHAL()
+{
+    std::lock_guard<std::mutex> lock(g_pathIndexMutex);
+    std::atomic_store(&g_pathIndex, initPathIndex());
+}
+
+void initPHALOnDemand()
+{
+    g_initPHALOnDemand = true;
+}
+
+/**
+ * @brief Normalize the given physical path into device tree format
+ *
+ * The device tree keeps the physical path in lower case with "physical:"
+ * as prefix, so the given path is converted into that format in the
+ * caller buffer without any heap allocation.
+ * E.g: /sys-0/node-0/proc-0 => physical:sys-0/node-0/proc-0
+ *
+ * @param[in] physicalPath physical path in any supported format
+ * @param[out] devTreePath buffer to store the normalized physical path
+ * @return true on success, false if the normalized path does not fit
+ */
+static bool toDevTreePath(std::string_view physicalPath,
+                          ATTR_PHYS_DEV_PATH_Type& devTreePath)
+{
+    constexpr std::string_view prefix{"physical:"};
+    auto toLower = [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    };
 
     /**
-     * The ATTR_PHYS_BIN_PATH attribute value is matched with given
-     * physical path binary format value. so, getting physical path
-     * value by using ATTR_PHYS_DEV_PATH attribute from same target
-     * property list.
+     * Removing "/" as prefix in given path if found to match with
+     * device tree value
      */
-    // clear old value in g_physStringPath
-    std::memset(g_physStringPath, 0, sizeof(g_physStringPath));
+    if (!physicalPath.empty() && physicalPath.front() == '/')
+    {
+        physicalPath.remove_prefix(1);
+    }
 
-    if (DT_GET_PROP(ATTR_PHYS_DEV_PATH, target, g_physStringPath))
+    /**
+     * Adding "physical:" as prefix to given path to match with
+     * device tree value if not given
+     */
+    bool hasPrefix =
+        std::search(physicalPath.begin(), physicalPath.end(), prefix.begin(),
+                    prefix.end(), [&toLower](char given, char expected) {
+                        return toLower(given) == expected;
+                    }) != physicalPath.end();
+
+    size_t length = physicalPath.size() + (hasPrefix ? 0 : prefix.size());
+    if (length >= sizeof(devTreePath) /* To include NULL terminator */)
     {
-        /**
-         * Stopping the target traversal if ATTR_PHYS_DEV_PATH
-         * attribute not found within ATTR_PHYS_BIN_PATH attribute
-         * target property list
-         */
-        return requireAttrNotFound;
+        GUARD_LOG(
+            GUARD_ERROR,
+            "Physical path size mismatch with given[%zu] and max size[%zu]",
+            length, sizeof(devTreePath) - 1);
+        return false;
     }
-    else
+
+    char* dst = devTreePath;
+    if (!hasPrefix)
     {
-        /**
-         * Found the physical path value from device tree by using
-         * given physical path binary value.
-         */
-        return requireAttrFound;
+        dst = std::copy(prefix.begin(), prefix.end(), dst);
     }
+
+    /**
+     * Make sure physicalPath is in lower case because,
+     * in device tree physical path is in lower case
+     */
+    dst = std::transform(physicalPath.begin(), physicalPath.end(), dst,
+                         toLower);
+    *dst = '\0';
+
+    return true;
 }
 
-std::optional<std::string>
-    getPhysicalPathFromDevTree(const EntityPath& entityPath)
+std::optional<EntityPath>
+    getEntityPathFromDevTree(std::string_view physicalPath)
 {
     /**
-     * The callback function (pdbgCallbackToGetPhysicalPath) will use
-     * the given physical binary path from g_physBinaryPath variable.
-     * so, clearing old value in g_physBinaryPath.
+     * The caller given value of physical path will be below format if not
+     * in device tree format to get raw data of physical path.
+     * E.g: physical:sys-0/node-0/proc-0
      */
-    std::memset(g_physBinaryPath, 0, sizeof(g_physBinaryPath));
+    ATTR_PHYS_DEV_PATH_Type devTreePath;
+    if (!toDevTreePath(physicalPath, devTreePath))
+    {
+        return std::nullopt;
+    }
 
-    if (sizeof(EntityPath) > sizeof(g_physBinaryPath))
+    auto pathIndex = getPathIndex();
+    auto it = pathIndex->byPhysStringPath.find(devTreePath);
+    if (it == pathIndex->byPhysStringPath.end())
     {
-        log::guard_log(
+        GUARD_LOG(
             GUARD_ERROR,
-            "Physical path binary size mismatch with devtree[%zu] guard[%zu]",
-            sizeof(g_physBinaryPath), sizeof(EntityPath));
+            "Given physical path not found in power system device tree");
         return std::nullopt;
     }
 
-    int rdIndex = 0;
-    g_physBinaryPath[rdIndex++] = entityPath.type_size;
+    return pathIndex->entries[it->second].entityPath;
+}
 
-    /**
-     * Path elements size stored at last 4bits in type_size member.
-     * For every iteration, increasing 2 byte to store PathElement value
-     * i.e target type enum value and instance id as raw data.
-     *
-     * @note PathElement targetType and instance member data type are
-     * uint8_t. so, directly assiging each value as one byte to make
-     * raw data (binary) format. If data type are changed for those fields
-     * in PathElements then this logic also need to revisit.
-     */
-    for (int i = 0; i < (0x0F & entityPath.type_size);
-         i++, rdIndex += sizeof(entityPath.pathElements[0]))
+/**
+ * @brief To get physical path from the physical path index
+ *
+ * @param[in] pathIndex the physical path index
+ * @param[in] entityPath to pass entity path value
+ * @return Physical path if found in the index else NULL
+ */
+static std::optional<std::string>
+    getPhysicalPathFromIndex(const PathIndex& pathIndex,
+                             const EntityPath& entityPath)
+{
+    auto it = pathIndex.byEntityPath.find(entityPath);
+    if (it == pathIndex.byEntityPath.end())
     {
-        g_physBinaryPath[rdIndex] = entityPath.pathElements[i].targetType;
-        g_physBinaryPath[rdIndex + 1] = entityPath.pathElements[i].instance;
+        return std::nullopt;
     }
 
-    int ret = pdbg_target_traverse(
-        nullptr /* Passing NULL to start target traversal from root */,
-        pdbgCallbackToGetPhysicalPath,
-        nullptr /* No application private data, so passing NULL */);
+    const auto& entry = pathIndex.entries[it->second];
+    return std::string(entry.physStringPath,
+                       strnlen(entry.physStringPath,
+                               sizeof(entry.physStringPath)));
+}
 
-    if (ret == 0)
+std::optional<std::string>
+    getPhysicalPathFromDevTree(const EntityPath& entityPath)
+{
+    auto physicalPath = getPhysicalPathFromIndex(*getPathIndex(), entityPath);
+    if (!physicalPath)
     {
-        log::guard_log(
+        GUARD_LOG(
             GUARD_ERROR,
             "Given binary physical path not found in power system device tree");
-        return std::nullopt;
     }
-    else if (ret == requireAttrNotFound)
+    return physicalPath;
+}
+
+std::optional<size_t> copyPhysicalPathFromDevTree(const EntityPath& entityPath,
+                                                  char* buf, size_t size)
+{
+    auto pathIndex = getPathIndex();
+    auto it = pathIndex->byEntityPath.find(entityPath);
+    if (it == pathIndex->byEntityPath.end())
     {
-        log::guard_log(GUARD_ERROR, "String value for binary physical path is "
-                                    "not found in device tree");
+        GUARD_LOG(
+            GUARD_ERROR,
+            "Given binary physical path not found in power system device tree");
         return std::nullopt;
     }
 
-    return std::string(g_physStringPath, sizeof(g_physStringPath));
+    const auto& entry = pathIndex->entries[it->second];
+    size_t length =
+        strnlen(entry.physStringPath, sizeof(entry.physStringPath));
+    if (length < size)
+    {
+        memcpy(buf, entry.physStringPath, length);
+        buf[length] = '\0';
+    }
+    return length;
+}
+
+std::vector<std::optional<std::string>>
+    getPhysicalPathsFromDevTree(const std::vector<EntityPath>& entityPaths)
+{
+    auto pathIndex = getPathIndex();
+
+    std::vector<std::optional<std::string>> physicalPaths;
+    physicalPaths.reserve(entityPaths.size());
+    size_t notFound = 0;
+    for (const auto& entityPath : entityPaths)
+    {
+        physicalPaths.emplace_back(
+            getPhysicalPathFromIndex(*pathIndex, entityPath));
+        if (!physicalPaths.back())
+        {
+            notFound++;
+        }
+    }
+
+    if (notFound > 0)
+    {
+        GUARD_LOG(GUARD_ERROR,
+                  "%zu of %zu binary physical paths are not found in "
+                  "power system device tree",
+                  notFound, entityPaths.size());
+    }
+    return physicalPaths;
+}
+
+std::optional<FruVpd> getFruVpdFromDevTree(const EntityPath& entityPath)
+{
+    auto pathIndex = getPathIndex();
+    auto it = pathIndex->byEntityPath.find(entityPath);
+    if ((it == pathIndex->byEntityPath.end()) ||
+        !pathIndex->entries[it->second].hasFruVpd)
+    {
+        return std::nullopt;
+    }
+    return pathIndex->entries[it->second].fruVpd;
 }
 } // namespace phal
 } // namespace guard
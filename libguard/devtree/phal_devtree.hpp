@@ -15,11 +15,19 @@
  *
  * To use device tree need to do init required phal library (libpdbg) and
  * same can be achieved by using initPHAL() api.
+ *
+ * The physical path values of all the targets are indexed by a single
+ * device tree traversal, so the conversion api's do not walk the device
+ * tree for every lookup. The VPD of the FRU containing the target is
+ * indexed along with it. The conversion api's are thread safe.
  */
 
 #include "guard_common.hpp"
 
+#include <array>
 #include <optional>
+#include <string_view>
+#include <vector>
 
 namespace openpower
 {
@@ -27,13 +35,43 @@ namespace guard
 {
 namespace phal
 {
+/**
+ * @brief VPD of the FRU which contains the target
+ *
+ * The values are in IBM 11S format, the same as stored in guard record.
+ */
+struct FruVpd
+{
+    std::array<uint8_t, 12> serialNum; ///< FRU serial number
+    std::array<uint8_t, 7> partNum;    ///< FRU part number
+};
+
 /**
  * @brief To init phal library for use power system specific device tree
  *
+ * Also builds the physical path index which is used by the conversion
+ * api's. If the caller initialises libpdbg itself then, the index will
+ * be built during the first conversion.
+ *
  * @return void
  */
 void initPHAL();
 
+/**
+ * @brief To init phal library during the first physical path conversion
+ *
+ * Same as initPHAL() but deferred until a conversion api really needs
+ * the device tree, so the users which never convert a physical path do
+ * not pay the device tree initialisation cost. The initialisation is
+ * done only once even if many threads are doing the first conversion.
+ *
+ * @return void
+ *
+ * @note The conversion api's throw the initPHAL() exception if the
+ *       deferred initialisation is failed.
+ */
+void initPHALOnDemand();
+
 /**
  * @brief Get entity path value from device tree
  *
@@ -43,9 +81,12 @@ void initPHAL();
  *
  * @param[in] physicalPath to pass physical path value
  * @return EntityPath if found in device tree else NULL
+ *
+ * @note The given path is normalized into the device tree format on the
+ *       stack, so the lookup does not allocate.
  */
 std::optional<EntityPath>
-    getEntityPathFromDevTree(const std::string& physicalPath);
+    getEntityPathFromDevTree(std::string_view physicalPath);
 
 /**
  * @brief Get physical path from device tree by using EntityPath value
@@ -59,6 +100,46 @@ std::optional<EntityPath>
  */
 std::optional<std::string>
     getPhysicalPathFromDevTree(const EntityPath& entityPath);
+
+/**
+ * @brief Copy physical path from device tree into the given buffer
+ *
+ * Same as getPhysicalPathFromDevTree() but, the physical path is copied
+ * from the physical path index without allocating.
+ *
+ * @param[in] entityPath to pass entity path value
+ * @param[out] buf buffer to copy the NULL terminated physical path
+ * @param[in] size size of the buffer
+ * @return Length of the physical path if found in device tree else NULL,
+ *         the physical path is copied only if it fits in the buffer
+ */
+std::optional<size_t> copyPhysicalPathFromDevTree(const EntityPath& entityPath,
+                                                  char* buf, size_t size);
+
+/**
+ * @brief Get physical paths from device tree by using EntityPath values
+ *
+ * Same as getPhysicalPathFromDevTree() for the set of entity paths,
+ * resolved against the same physical path index.
+ *
+ * @param[in] entityPaths to pass entity path values
+ * @return Physical paths in the same order as the given entity paths,
+ *         NULL for the entity paths which are not found in device tree
+ */
+std::vector<std::optional<std::string>>
+    getPhysicalPathsFromDevTree(const std::vector<EntityPath>& entityPaths);
+
+/**
+ * @brief Get VPD of the FRU which contains the given target
+ *
+ * The FRU VPD (ATTR_SERIAL_NUMBER and ATTR_PART_NUMBER) is collected
+ * along with the physical path index so, no device tree traversal is
+ * required to get it.
+ *
+ * @param[in] entityPath to pass entity path value
+ * @return FRU VPD if found in device tree else NULL
+ */
+std::optional<FruVpd> getFruVpdFromDevTree(const EntityPath& entityPath);
 } // namespace phal
 } // namespace guard
 } // namespace openpower
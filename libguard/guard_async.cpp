@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_async.hpp"
+
+#include "guard_error.hpp"
+#include "guard_file.hpp"
+#include "guard_interface.hpp"
+#include "guard_interface_impl.hpp"
+#include "guard_log.hpp"
+
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace openpower
+{
+namespace guard
+{
+/**
+ * @brief Return the exception of the synchronous API for the error code
+ */
+static std::exception_ptr toException(const std::error_code& ec)
+{
+    try
+    {
+        throwGuardError(ec);
+    }
+    catch (...)
+    {
+        return std::current_exception();
+    }
+}
+
+/**
+ * @brief Write the changed parts of the guard file image
+ *
+ * The changes which are closer than a guard record are written together,
+ * so the adjacent records are written at once.
+ *
+ * @param[in] file guard file to write
+ * @param[in] original content of the guard file before the changes
+ * @param[in] image changed content of the guard file
+ *
+ * @return NULL, throws the guard file exceptions on the failures
+ */
+static void writeChanges(GuardFile& file, const std::vector<uint8_t>& original,
+                         const std::vector<uint8_t>& image)
+{
+    forEachChange(original.data(), image.data(), image.size(),
+                  sizeof(GuardRecord), [&](size_t start, size_t end) {
+                      file.write(start, image.data() + start, end - start);
+                  });
+}
+
+AsyncGuard::AsyncGuard(size_t capacity, Overflow overflow) :
+    guardFile(getGuardFilePath()), guardLayout(getGuardLayout()),
+    capacity(capacity > 0 ? capacity : 1),
+    overflow(overflow)
+{
+    worker = std::thread(&AsyncGuard::run, this);
+}
+
+AsyncGuard::~AsyncGuard()
+{
+    shutdown();
+}
+
+void AsyncGuard::create(const EntityPath& entityPath, uint32_t eId,
+                        uint8_t eType, bool overwriteRecord,
+                        CreateCallback callback)
+{
+    submit({Operation::Type::Create, entityPath, eId, eType, overwriteRecord,
+            std::move(callback)});
+}
+
+std::future<GuardRecord> AsyncGuard::create(const EntityPath& entityPath,
+                                            uint32_t eId, uint8_t eType,
+                                            bool overwriteRecord)
+{
+    auto promise = std::make_shared<std::promise<GuardRecord>>();
+    auto future = promise->get_future();
+    create(entityPath, eId, eType, overwriteRecord,
+           [promise](const GuardRecord& record, std::error_code ec) {
+               if (ec)
+               {
+                   promise->set_exception(toException(ec));
+                   return;
+               }
+               promise->set_value(record);
+           });
+    return future;
+}
+
+void AsyncGuard::clear(const EntityPath& entityPath, bool forceClear,
+                       ClearCallback callback)
+{
+    submit({Operation::Type::ClearPath, entityPath, 0, 0, forceClear,
+            [callback = std::move(callback)](const GuardRecord&,
+                                             std::error_code ec) {
+                callback(ec);
+            }});
+}
+
+std::future<void> AsyncGuard::clear(const EntityPath& entityPath,
+                                    bool forceClear)
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    clear(entityPath, forceClear, [promise](std::error_code ec) {
+        if (ec)
+        {
+            promise->set_exception(toException(ec));
+            return;
+        }
+        promise->set_value();
+    });
+    return future;
+}
+
+void AsyncGuard::clear(uint32_t recordId, bool forceClear,
+                       ClearCallback callback)
+{
+    submit({Operation::Type::ClearId, EntityPath(), recordId, 0, forceClear,
+            [callback = std::move(callback)](const GuardRecord&,
+                                             std::error_code ec) {
+                callback(ec);
+            }});
+}
+
+std::future<void> AsyncGuard::clear(uint32_t recordId, bool forceClear)
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    clear(recordId, forceClear, [promise](std::error_code ec) {
+        if (ec)
+        {
+            promise->set_exception(toException(ec));
+            return;
+        }
+        promise->set_value();
+    });
+    return future;
+}
+
+void AsyncGuard::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto target = submitted;
+    completed.wait(lock, [this, target] { return done >= target; });
+}
+
+void AsyncGuard::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    queued.notify_all();
+    dequeued.notify_all();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void AsyncGuard::submit(Operation&& operation)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (overflow == Overflow::Block)
+    {
+        dequeued.wait(lock,
+                      [this] { return stop || (queue.size() < capacity); });
+    }
+
+    if (stop || (queue.size() >= capacity))
+    {
+        auto ec = stop
+                      ? std::make_error_code(std::errc::operation_canceled)
+                      : std::make_error_code(
+                            std::errc::resource_unavailable_try_again);
+        lock.unlock();
+        GuardRecord guard;
+        memset(&guard, 0xff, sizeof(guard));
+        operation.done(guard, ec);
+        return;
+    }
+
+    queue.push_back(std::move(operation));
+    submitted++;
+    lock.unlock();
+    queued.notify_one();
+}
+
+void AsyncGuard::process(std::deque<Operation>& batch)
+{
+    struct Result
+    {
+        GuardRecord record;
+        std::error_code ec;
+    };
+
+    std::vector<Result> results(batch.size());
+    for (auto& result : results)
+    {
+        memset(&result.record, 0xff, sizeof(result.record));
+    }
+
+    try
+    {
+        GuardFile file(guardFile, guardLayout);
+        std::vector<uint8_t> original(file.size());
+        file.read(0, original.data(), original.size());
+        std::vector<uint8_t> image(original);
+
+        // Apply the operations in the queued order, each operation sees
+        // the changes of the operations before
+        file.setImage(image.data());
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            const auto& operation = batch[i];
+            auto& result = results[i];
+            try
+            {
+                switch (operation.type)
+                {
+                    case Operation::Type::Create:
+                        result.record = impl::createRecord(
+                            file, operation.entityPath, operation.id,
+                            operation.eType, operation.flag, result.ec);
+                        break;
+                    case Operation::Type::ClearPath:
+                        result.ec = impl::invalidateRecord(
+                            file, operation.entityPath, operation.flag);
+                        break;
+                    case Operation::Type::ClearId:
+                        result.ec = impl::invalidateRecord(file, operation.id,
+                                                           operation.flag);
+                        break;
+                }
+            }
+            catch (...)
+            {
+                result.ec = currentErrorCode();
+            }
+        }
+        file.setImage(nullptr);
+
+        writeChanges(file, original, image);
+        GUARD_LOG(GUARD_DEBUG, "Completed %zu queued guard operations",
+                  batch.size());
+    }
+    catch (...)
+    {
+        // None of the changes are known to be written
+        auto ec = currentErrorCode();
+        for (auto& result : results)
+        {
+            if (!result.ec)
+            {
+                result.ec = ec;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        batch[i].done(results[i].record, results[i].ec);
+    }
+}
+
+void AsyncGuard::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        queued.wait(lock, [this] { return stop || !queue.empty(); });
+        if (queue.empty())
+        {
+            // Stopped and, the queued operations are completed
+            break;
+        }
+
+        std::deque<Operation> batch;
+        batch.swap(queue);
+        dequeued.notify_all();
+
+        lock.unlock();
+        process(batch);
+        lock.lock();
+
+        done += batch.size();
+        completed.notify_all();
+    }
+}
+} // namespace guard
+} // namespace openpower
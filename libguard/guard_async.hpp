@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "guard_entity.hpp"
+#include "include/guard_record.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace openpower
+{
+namespace guard
+{
+namespace fs = std::filesystem;
+
+/**
+ * @class AsyncGuard
+ *
+ * Asynchronous front-end of the guard record create and clear APIs, for
+ * the applications which must not block on the guard file I/O, e.g. an
+ * event loop. The operations are queued to a worker thread which applies
+ * all the queued operations on an image of the guard file and writes the
+ * changed parts at once, so the adjacent records written by the queued
+ * operations share one write.
+ *
+ * The completion is reported through the callback, which is called from
+ * the worker thread after the changes are written to the guard file, or
+ * through the future. The errors are the same as the std::error_code
+ * variants of the synchronous APIs. The callbacks must not throw and,
+ * must not call flush() since they are called from the worker thread.
+ */
+class AsyncGuard
+{
+  public:
+    /**
+     * @brief Behavior of the submit when the queue is full
+     *
+     * Block  - Wait until there is space in the queue.
+     * Reject - Complete the operation with the
+     *          std::errc::resource_unavailable_try_again error, without
+     *          blocking. The callback is called from the caller thread.
+     */
+    enum class Overflow
+    {
+        Block,
+        Reject
+    };
+
+    using CreateCallback =
+        std::function<void(const GuardRecord& record, std::error_code ec)>;
+    using ClearCallback = std::function<void(std::error_code ec)>;
+
+    AsyncGuard(const AsyncGuard&) = delete;
+    AsyncGuard& operator=(const AsyncGuard&) = delete;
+    AsyncGuard(AsyncGuard&&) = delete;
+    AsyncGuard& operator=(AsyncGuard&&) = delete;
+
+    /**
+     * @brief Constructor, starts the worker thread for the guard file in
+     *        use i.e. libguard_init() must be called already
+     *
+     * @param[in] capacity maximum number of the queued operations
+     * @param[in] overflow behavior of the submit when the queue is full
+     */
+    explicit AsyncGuard(size_t capacity = 64,
+                        Overflow overflow = Overflow::Block);
+
+    /**
+     * @brief Destructor, completes the queued operations and stops the
+     *        worker thread
+     */
+    ~AsyncGuard();
+
+    /**
+     * @brief Queue the guard record creation, see create()
+     *
+     * @param[in] callback called with the created record on completion
+     *
+     * @return NULL
+     */
+    void create(const EntityPath& entityPath, uint32_t eId, uint8_t eType,
+                bool overwriteRecord, CreateCallback callback);
+
+    /**
+     * @brief Queue the guard record creation, see create()
+     *
+     * @return future of the created record, which throws the exception of
+     *         the synchronous create() on failure
+     */
+    std::future<GuardRecord> create(const EntityPath& entityPath,
+                                    uint32_t eId = 0,
+                                    uint8_t eType = GARD_User_Manual,
+                                    bool overwriteRecord = true);
+
+    /**
+     * @brief Queue the resolution of the guard record of the target, see
+     *        clear()
+     *
+     * @param[in] callback called on completion
+     *
+     * @return NULL
+     */
+    void clear(const EntityPath& entityPath, bool forceClear,
+               ClearCallback callback);
+
+    /**
+     * @brief Queue the resolution of the guard record of the target, see
+     *        clear()
+     *
+     * @return future which throws the exception of the synchronous
+     *         clear() on failure
+     */
+    std::future<void> clear(const EntityPath& entityPath,
+                            bool forceClear = false);
+
+    /**
+     * @brief Queue the resolution of the guard record of the record id,
+     *        see clear()
+     *
+     * @param[in] callback called on completion
+     *
+     * @return NULL
+     */
+    void clear(uint32_t recordId, bool forceClear, ClearCallback callback);
+
+    /**
+     * @brief Queue the resolution of the guard record of the record id,
+     *        see clear()
+     *
+     * @return future which throws the exception of the synchronous
+     *         clear() on failure
+     */
+    std::future<void> clear(uint32_t recordId, bool forceClear = false);
+
+    /**
+     * @brief Wait until the operations queued before are completed
+     *
+     * @return NULL
+     */
+    void flush();
+
+    /**
+     * @brief Complete the queued operations and stop the worker thread,
+     *        the operations queued after are completed with the
+     *        std::errc::operation_canceled error
+     *
+     * @return NULL
+     */
+    void shutdown();
+
+  private:
+    /**
+     * @brief Queued operation
+     */
+    struct Operation
+    {
+        enum class Type
+        {
+            Create,
+            ClearPath,
+            ClearId
+        };
+
+        Type type;
+        EntityPath entityPath;
+        uint32_t id; ///< Error log id to create, record id to clear
+        uint8_t eType;
+        bool flag; ///< Overwrite to create, force to clear
+        CreateCallback done;
+    };
+
+    void submit(Operation&& operation);
+    void process(std::deque<Operation>& batch);
+    void run();
+
+    fs::path guardFile;
+    GuardLayout guardLayout;
+    size_t capacity;
+    Overflow overflow;
+
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable dequeued;
+    std::condition_variable completed;
+    std::deque<Operation> queue;
+    uint64_t submitted = 0;
+    uint64_t done = 0;
+    bool stop = false;
+    std::thread worker;
+};
+} // namespace guard
+} // namespace openpower
@@ -0,0 +1,399 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "config.h"
+
+#include "guard_c.h"
+
+#include "guard_codec.hpp"
+#include "guard_entity.hpp"
+#include "guard_error.hpp"
+#include "guard_file.hpp"
+#include "guard_interface.hpp"
+#include "guard_interface_impl.hpp"
+#include "guard_stats.hpp"
+#include "include/guard_record.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace openpower
+{
+namespace guard
+{
+namespace
+{
+// The entity paths are copied as is and, the fields of the records up to
+// the type are at the same offsets
+static_assert(sizeof(guard_entity_path) == sizeof(EntityPath));
+static_assert(sizeof(guard_record) >= sizeof(GuardRecord));
+static_assert(offsetof(guard_record, target_id) ==
+              offsetof(GuardRecord, targetId));
+static_assert(offsetof(guard_record, elog_id) == offsetof(GuardRecord, elogId));
+static_assert(offsetof(guard_record, err_type) ==
+              offsetof(GuardRecord, errType));
+
+constexpr uint32_t handleOpen = 0x47524400; // "GRD"
+
+/**
+ * @brief Content of guard_handle_t, the GUARD file is constructed in
+ *        the caller provided storage
+ */
+struct HandleState
+{
+    alignas(GuardFile) unsigned char file[sizeof(GuardFile)];
+    uint32_t magic;
+};
+static_assert(sizeof(HandleState) <= sizeof(guard_handle_t));
+static_assert(alignof(HandleState) <= alignof(guard_handle_t));
+
+HandleState* getState(guard_handle_t* handle)
+{
+    return reinterpret_cast<HandleState*>(handle->opaque);
+}
+
+/**
+ * @brief Return the opened GUARD file of the handle
+ *
+ * @return GUARD file, nullptr if the handle is not opened
+ */
+GuardFile* getFile(guard_handle_t* handle)
+{
+    if ((handle == nullptr) || (getState(handle)->magic != handleOpen))
+    {
+        return nullptr;
+    }
+    return std::launder(reinterpret_cast<GuardFile*>(getState(handle)->file));
+}
+
+guard_status_t toStatus(const std::error_code& ec)
+{
+    if (!ec)
+    {
+        return GUARD_STATUS_OK;
+    }
+    if (ec.category() == guardErrorCategory())
+    {
+        return static_cast<guard_status_t>(ec.value());
+    }
+    if (ec == std::errc::not_enough_memory)
+    {
+        return GUARD_STATUS_NO_MEMORY;
+    }
+    return GUARD_STATUS_IO_ERROR;
+}
+
+const EntityPath& toEntityPath(const guard_entity_path* entityPath)
+{
+    return *reinterpret_cast<const EntityPath*>(entityPath);
+}
+
+void toCRecord(const GuardRecord& record, guard_record* cRecord)
+{
+    // The fields after the type are different in the PGUARD record
+    constexpr size_t copySize =
+        (sizeof(GuardRecord) == sizeof(guard_record))
+            ? sizeof(guard_record)
+            : offsetof(GuardRecord, errType) + sizeof(record.errType);
+    memcpy(cRecord, &record, copySize);
+    memset(reinterpret_cast<uint8_t*>(cRecord) + copySize, 0xff,
+           sizeof(guard_record) - copySize);
+}
+} // namespace
+} // namespace guard
+} // namespace openpower
+
+using namespace openpower::guard;
+
+extern "C" {
+
+guard_status_t guard_open(guard_handle_t* handle, const char* path)
+{
+    if (handle == nullptr)
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    auto* state = getState(handle);
+    state->magic = 0;
+    try
+    {
+        auto* file = new (state->file)
+            GuardFile(path != nullptr ? path : GUARD_PRSV_PATH);
+        try
+        {
+            if (file->size() == 0)
+            {
+                GUARD_LOG(GUARD_ERROR, "Empty Guard file");
+                file->~GuardFile();
+                return GUARD_STATUS_INVALID_GUARD_FILE;
+            }
+            impl::initializeHeader(*file);
+        }
+        catch (...)
+        {
+            file->~GuardFile();
+            throw;
+        }
+    }
+    catch (...)
+    {
+        return toStatus(currentErrorCode());
+    }
+    state->magic = handleOpen;
+    return GUARD_STATUS_OK;
+}
+
+guard_status_t guard_close(guard_handle_t* handle)
+{
+    auto* file = getFile(handle);
+    if (file == nullptr)
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+    file->~GuardFile();
+    getState(handle)->magic = 0;
+    return GUARD_STATUS_OK;
+}
+
+guard_status_t guard_create(guard_handle_t* handle,
+                            const guard_entity_path* entity_path,
+                            uint32_t elog_id, uint8_t err_type, int overwrite,
+                            guard_record* record)
+{
+    auto* file = getFile(handle);
+    if ((file == nullptr) || (entity_path == nullptr))
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    stats::LatencyTimer timer(stats::Api::Create);
+    std::error_code ec;
+    try
+    {
+        auto guard = impl::createRecord(*file, toEntityPath(entity_path),
+                                        elog_id, err_type, overwrite != 0, ec);
+        if (!ec && (record != nullptr))
+        {
+            toCRecord(guard, record);
+        }
+    }
+    catch (...)
+    {
+        ec = currentErrorCode();
+    }
+    return toStatus(ec);
+}
+
+guard_status_t guard_get_all(guard_handle_t* handle, int persistent_only,
+                             guard_record* records, size_t capacity,
+                             size_t* count)
+{
+    auto* file = getFile(handle);
+    if ((file == nullptr) || (count == nullptr) ||
+        ((records == nullptr) && (capacity > 0)))
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    stats::LatencyTimer timer(stats::Api::GetAll);
+    *count = 0;
+    try
+    {
+        forEachRecord(*file, [&](const GuardRecord& curRecord, int) {
+            if ((persistent_only && isEphemeralType(curRecord.errType)) ||
+                !isRecordIntact(curRecord))
+            {
+                return;
+            }
+            if (*count < capacity)
+            {
+                toCRecord(getHostEndiannessRecord(curRecord),
+                          &records[*count]);
+            }
+            (*count)++;
+        });
+    }
+    catch (...)
+    {
+        return toStatus(currentErrorCode());
+    }
+    return (*count > capacity) ? GUARD_STATUS_BUFFER_TOO_SMALL
+                               : GUARD_STATUS_OK;
+}
+
+guard_status_t guard_clear_by_path(guard_handle_t* handle,
+                                   const guard_entity_path* entity_path,
+                                   int force)
+{
+    auto* file = getFile(handle);
+    if ((file == nullptr) || (entity_path == nullptr))
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    stats::LatencyTimer timer(stats::Api::Clear);
+    try
+    {
+        return toStatus(impl::invalidateRecord(
+            *file, toEntityPath(entity_path), force != 0));
+    }
+    catch (...)
+    {
+        return toStatus(currentErrorCode());
+    }
+}
+
+guard_status_t guard_clear_by_id(guard_handle_t* handle, uint32_t record_id,
+                                 int force)
+{
+    auto* file = getFile(handle);
+    if (file == nullptr)
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    stats::LatencyTimer timer(stats::Api::Clear);
+    try
+    {
+        return toStatus(
+            impl::invalidateRecord(*file, record_id, force != 0));
+    }
+    catch (...)
+    {
+        return toStatus(currentErrorCode());
+    }
+}
+
+guard_status_t guard_invalidate_all(guard_handle_t* handle)
+{
+    auto* file = getFile(handle);
+    if (file == nullptr)
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    stats::LatencyTimer timer(stats::Api::InvalidateAll);
+    try
+    {
+        impl::invalidateAll(*file);
+    }
+    catch (...)
+    {
+        return toStatus(currentErrorCode());
+    }
+    return GUARD_STATUS_OK;
+}
+
+guard_status_t guard_clear_all(guard_handle_t* handle)
+{
+    auto* file = getFile(handle);
+    if (file == nullptr)
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    try
+    {
+        file->erase(0, file->size());
+    }
+    catch (...)
+    {
+        return toStatus(currentErrorCode());
+    }
+    return GUARD_STATUS_OK;
+}
+
+guard_status_t guard_get_entity_path(const char* physical_path,
+                                     guard_entity_path* entity_path)
+{
+    if ((physical_path == nullptr) || (entity_path == nullptr))
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    try
+    {
+        auto path = getEntityPath(physical_path);
+        if (!path)
+        {
+            return GUARD_STATUS_INVALID_ENTITY_PATH;
+        }
+        memcpy(entity_path, &(*path), sizeof(*entity_path));
+    }
+    catch (...)
+    {
+        return toStatus(currentErrorCode());
+    }
+    return GUARD_STATUS_OK;
+}
+
+guard_status_t guard_get_physical_path(const guard_entity_path* entity_path,
+                                       char* buf, size_t size, size_t* length)
+{
+    if ((entity_path == nullptr) || ((buf == nullptr) && (size > 0)))
+    {
+        return GUARD_STATUS_INVALID_ARGUMENT;
+    }
+
+    try
+    {
+        auto pathLength =
+            copyPhysicalPath(toEntityPath(entity_path), buf, size);
+        if (!pathLength)
+        {
+            return GUARD_STATUS_INVALID_ENTITY_PATH;
+        }
+        if (length != nullptr)
+        {
+            *length = *pathLength;
+        }
+        if (*pathLength >= size)
+        {
+            return GUARD_STATUS_BUFFER_TOO_SMALL;
+        }
+    }
+    catch (...)
+    {
+        return toStatus(currentErrorCode());
+    }
+    return GUARD_STATUS_OK;
+}
+
+const char* guard_status_str(guard_status_t status)
+{
+    switch (status)
+    {
+        case GUARD_STATUS_OK:
+            return "Success";
+        case GUARD_STATUS_INVALID_GUARD_FILE:
+            return "Invalid guard file";
+        case GUARD_STATUS_GUARD_FILE_OPEN_FAILED:
+            return "Failed to open guard file";
+        case GUARD_STATUS_GUARD_FILE_READ_FAILED:
+            return "Failed to read from guard file";
+        case GUARD_STATUS_GUARD_FILE_WRITE_FAILED:
+            return "Failed to write to the guard file";
+        case GUARD_STATUS_GUARD_FILE_SEEK_FAILED:
+            return "Failed to move to the position in the guard file";
+        case GUARD_STATUS_INVALID_ENTRY:
+            return "Invalid parameter";
+        case GUARD_STATUS_ALREADY_GUARDED:
+            return "Guard record is already exist";
+        case GUARD_STATUS_INVALID_ENTITY_PATH:
+            return "Guard record not found";
+        case GUARD_STATUS_CANNOT_DELETE:
+            return "Cannot delete a non-core system generated guard record";
+        case GUARD_STATUS_GUARD_FILE_OVERFLOWED:
+            return "Enough size is not available in GUARD file";
+        case GUARD_STATUS_BUFFER_TOO_SMALL:
+            return "Buffer is too small";
+        case GUARD_STATUS_INVALID_ARGUMENT:
+            return "Invalid argument";
+        case GUARD_STATUS_NO_MEMORY:
+            return "Not enough memory";
+        case GUARD_STATUS_IO_ERROR:
+            return "I/O error";
+    }
+    return "Unknown guard status";
+}
+}
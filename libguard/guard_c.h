@@ -0,0 +1,235 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+#ifndef LIBGUARD_GUARD_C_H
+#define LIBGUARD_GUARD_C_H
+
+/**
+ * C interface of libguard
+ *
+ * The records and the physical paths are returned in the caller provided
+ * arrays and buffers, the GUARD file is kept open in the caller provided
+ * handle and, the failures are returned as status codes so, the library
+ * does not allocate on success. The records are plain structs of a fixed
+ * layout, which does not depend on how libguard is built.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Status codes, the failures from GUARD_STATUS_INVALID_GUARD_FILE
+ *        to GUARD_STATUS_GUARD_FILE_OVERFLOWED have the same value as the
+ *        libguard C++ errors (openpower::guard::GuardError)
+ */
+typedef enum guard_status
+{
+    GUARD_STATUS_OK = 0,
+    GUARD_STATUS_INVALID_GUARD_FILE = 1,
+    GUARD_STATUS_GUARD_FILE_OPEN_FAILED = 2,
+    GUARD_STATUS_GUARD_FILE_READ_FAILED = 3,
+    GUARD_STATUS_GUARD_FILE_WRITE_FAILED = 4,
+    GUARD_STATUS_GUARD_FILE_SEEK_FAILED = 5,
+    GUARD_STATUS_INVALID_ENTRY = 6,
+    GUARD_STATUS_ALREADY_GUARDED = 7,
+    GUARD_STATUS_INVALID_ENTITY_PATH = 8,
+    GUARD_STATUS_CANNOT_DELETE = 9,
+    GUARD_STATUS_GUARD_FILE_OVERFLOWED = 10,
+    GUARD_STATUS_BUFFER_TOO_SMALL = 64, ///< Caller buffer is too small
+    GUARD_STATUS_INVALID_ARGUMENT = 65, ///< NULL pointer or closed handle
+    GUARD_STATUS_NO_MEMORY = 66,
+    GUARD_STATUS_IO_ERROR = 67 ///< Any other failure
+} guard_status_t;
+
+#define GUARD_C_MAX_PATH_ELEMENTS 10
+
+/* Same layout as openpower::guard::EntityPath */
+struct guard_entity_path
+{
+    uint8_t type_size; ///< Path type (high nibble) and element count
+    struct
+    {
+        uint8_t target_type;
+        uint8_t instance;
+    } __attribute__((__packed__)) path_elements[GUARD_C_MAX_PATH_ELEMENTS];
+} __attribute__((__packed__));
+
+/*
+ * Guard record in host endianness, the layout of the standard GUARD record
+ * in any build of libguard. The FRU VPD and the padding are 0xFF if the
+ * record does not have them, e.g. libguard is built with -DPGUARD.
+ */
+struct guard_record
+{
+    uint32_t record_id; ///< 0xFFFFFFFF for the resolved records
+    struct guard_entity_path target_id;
+    uint32_t elog_id;
+    uint8_t err_type;
+    union
+    {
+        uint8_t unique_id[80];
+        struct
+        {
+            uint8_t serial_num[12];
+            uint8_t part_num[7];
+        } __attribute__((__packed__)) s1;
+    } u;
+    uint8_t padding[18];
+} __attribute__((__packed__));
+
+/**
+ * @brief Storage of the opened GUARD file, the content is private
+ */
+typedef struct guard_handle
+{
+    uint64_t opaque[4];
+} guard_handle_t;
+
+/**
+ * @brief Open the GUARD file
+ *
+ * Same as libguard_init() for the given file, the magic number and the
+ * version are updated if they are not valid.
+ *
+ * @param[out] handle handle to keep the opened GUARD file
+ * @param[in] path GUARD file path, NULL for the default GUARD file
+ *
+ * @return GUARD_STATUS_OK on success
+ */
+guard_status_t guard_open(guard_handle_t* handle, const char* path);
+
+/**
+ * @brief Close the GUARD file
+ *
+ * @param[in,out] handle handle opened by guard_open()
+ *
+ * @return GUARD_STATUS_OK on success
+ */
+guard_status_t guard_close(guard_handle_t* handle);
+
+/**
+ * @brief Create the guard record
+ *
+ * @param[in] handle opened GUARD file
+ * @param[in] entity_path entity path of the target to guard
+ * @param[in] elog_id error log id
+ * @param[in] err_type guard record type, e.g. GARD_User_Manual (0xD2)
+ * @param[in] overwrite overwrite the existing record of the target with
+ *                      the higher priority type, if nonzero
+ * @param[out] record created record, may be NULL
+ *
+ * @return GUARD_STATUS_OK on success
+ */
+guard_status_t guard_create(guard_handle_t* handle,
+                            const struct guard_entity_path* entity_path,
+                            uint32_t elog_id, uint8_t err_type, int overwrite,
+                            struct guard_record* record);
+
+/**
+ * @brief Get the guard records, including the resolved records
+ *
+ * @param[in] handle opened GUARD file
+ * @param[in] persistent_only skip the ephemeral records, if nonzero
+ * @param[out] records array to fill the records, may be NULL if the
+ *                     capacity is 0
+ * @param[in] capacity number of records in the array
+ * @param[out] count number of the guard records, which can be more than
+ *                   the capacity
+ *
+ * @return GUARD_STATUS_OK on success, GUARD_STATUS_BUFFER_TOO_SMALL if
+ *         only the first capacity records are filled
+ */
+guard_status_t guard_get_all(guard_handle_t* handle, int persistent_only,
+                             struct guard_record* records, size_t capacity,
+                             size_t* count);
+
+/**
+ * @brief Resolve the guard record of the target
+ *
+ * @param[in] handle opened GUARD file
+ * @param[in] entity_path entity path of the guarded target
+ * @param[in] force resolve the system generated non-core record, if
+ *                  nonzero
+ *
+ * @return GUARD_STATUS_OK on success
+ */
+guard_status_t guard_clear_by_path(guard_handle_t* handle,
+                                   const struct guard_entity_path* entity_path,
+                                   int force);
+
+/**
+ * @brief Resolve the guard record of the record id
+ *
+ * @param[in] handle opened GUARD file
+ * @param[in] record_id id of the guard record
+ * @param[in] force resolve the system generated non-core record, if
+ *                  nonzero
+ *
+ * @return GUARD_STATUS_OK on success
+ */
+guard_status_t guard_clear_by_id(guard_handle_t* handle, uint32_t record_id,
+                                 int force);
+
+/**
+ * @brief Resolve all the guard records except the core records
+ *
+ * @param[in] handle opened GUARD file
+ *
+ * @return GUARD_STATUS_OK on success
+ */
+guard_status_t guard_invalidate_all(guard_handle_t* handle);
+
+/**
+ * @brief Erase the GUARD file
+ *
+ * @param[in] handle opened GUARD file
+ *
+ * @return GUARD_STATUS_OK on success
+ */
+guard_status_t guard_clear_all(guard_handle_t* handle);
+
+/**
+ * @brief Get the entity path of the physical path
+ *
+ * @param[in] physical_path NULL terminated physical path
+ * @param[out] entity_path entity path of the physical path
+ *
+ * @return GUARD_STATUS_OK on success, GUARD_STATUS_INVALID_ENTITY_PATH
+ *         if the physical path is not found
+ */
+guard_status_t guard_get_entity_path(const char* physical_path,
+                                     struct guard_entity_path* entity_path);
+
+/**
+ * @brief Get the physical path of the entity path
+ *
+ * @param[in] entity_path entity path
+ * @param[out] buf buffer to fill the NULL terminated physical path
+ * @param[in] size size of the buffer
+ * @param[out] length length of the physical path without the NULL
+ *                    terminator, may be NULL
+ *
+ * @return GUARD_STATUS_OK on success, GUARD_STATUS_INVALID_ENTITY_PATH
+ *         if the entity path is not found, GUARD_STATUS_BUFFER_TOO_SMALL
+ *         if the physical path does not fit in the buffer
+ */
+guard_status_t guard_get_physical_path(
+    const struct guard_entity_path* entity_path, char* buf, size_t size,
+    size_t* length);
+
+/**
+ * @brief Return the description of the status code
+ *
+ * @param[in] status status code
+ *
+ * @return static NULL terminated string
+ */
+const char* guard_status_str(guard_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBGUARD_GUARD_C_H */
@@ -0,0 +1,306 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "guard_file.hpp"
+#include "guard_scan.hpp"
+#include "guard_stats.hpp"
+#include "include/guard_record.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace openpower
+{
+namespace guard
+{
+/**
+ * Standard layout, "GUARDREC" header followed by 128 bytes records
+ */
+struct StandardLayout
+{
+    static constexpr GuardLayout layout = GuardLayout::Standard;
+    static constexpr size_t headerSize = 16;
+    static constexpr size_t recordSize = 128;
+};
+
+/**
+ * PGUARD layout, 37 bytes records without a header
+ */
+struct PGuardLayout
+{
+    static constexpr GuardLayout layout = GuardLayout::PGuard;
+    static constexpr size_t headerSize = 0;
+    static constexpr size_t recordSize = 37;
+};
+
+/**
+ * @class RecordCodec
+ *
+ * Guard record slots of the given layout, converted to and from the
+ * GuardRecord of the build. The record id, the target id, the error log id
+ * and the type are at the same offsets in both the layouts so, the
+ * conversion copies only them. The rest of the GuardRecord is 0xFF. The
+ * rest of the slot is kept when the record is updated in place by write()
+ * and, it is 0xFF when a new record is written by writeNew().
+ *
+ * The operations which scan the records are templates of the codec, so
+ * they are compiled for each layout and, the layout is checked only once
+ * per operation by withCodec().
+ */
+template <typename Layout>
+struct RecordCodec
+{
+    static constexpr GuardLayout layout = Layout::layout;
+    static constexpr size_t headerSize = Layout::headerSize;
+    static constexpr size_t recordSize = Layout::recordSize;
+
+    /**
+     * The GUARD file has the header, which has the header extension
+     */
+    static constexpr bool hasHeader = (headerSize > 0);
+
+    /**
+     * Slots read and classified at a time by scan()
+     */
+    static constexpr size_t scanChunk = 64;
+
+    /**
+     * The slot is the GuardRecord of the build as is, i.e. the fields after
+     * the type like the FRU VPD are kept
+     */
+    static constexpr bool isNative = (sizeof(GuardRecord) == recordSize);
+
+    /**
+     * Bytes of the slot which are kept in the GuardRecord, the fields after
+     * the type are different in the layouts
+     */
+    static constexpr size_t copySize =
+        isNative ? recordSize
+                 : offsetof(GuardRecord, errType) + sizeof(uint8_t);
+
+    static_assert(copySize <= std::min(sizeof(GuardRecord), recordSize));
+
+    /**
+     * @brief Return the offset of the slot in the GUARD file
+     */
+    static constexpr uint64_t offset(size_t pos)
+    {
+        return headerSize + (pos * recordSize);
+    }
+
+    /**
+     * @brief Return the number of the slots in the GUARD file of the size
+     */
+    static constexpr size_t slots(uint64_t fileSize)
+    {
+        return (fileSize < headerSize) ? 0
+                                       : (fileSize - headerSize) / recordSize;
+    }
+
+    /**
+     * @brief Convert the slot content to the GuardRecord
+     *
+     * @param[in] slot slot content of the layout
+     * @param[out] record guard record in the GUARD file format
+     *
+     * @return NULL
+     */
+    static void decode(const uint8_t* slot, GuardRecord& record)
+    {
+        memcpy(&record, slot, copySize);
+        if constexpr (copySize < sizeof(GuardRecord))
+        {
+            memset(reinterpret_cast<uint8_t*>(&record) + copySize, 0xff,
+                   sizeof(GuardRecord) - copySize);
+        }
+    }
+
+    /**
+     * @brief Read the slot at the given position
+     *
+     * @param[in] file GUARD file to read
+     * @param[in] pos position of the slot
+     * @param[out] record guard record in the GUARD file format
+     *
+     * @return NULL, throws the guard file exceptions on the failures
+     */
+    static void read(GuardFile& file, size_t pos, GuardRecord& record)
+    {
+        if constexpr (isNative)
+        {
+            file.read(offset(pos), &record, sizeof(record));
+        }
+        else
+        {
+            uint8_t slot[recordSize];
+            file.read(offset(pos), slot, sizeof(slot));
+            decode(slot, record);
+        }
+    }
+
+    /**
+     * @brief Write the record to the slot at the given position
+     *
+     * @param[in] file GUARD file to write
+     * @param[in] pos position of the slot
+     * @param[in] record guard record in the GUARD file format
+     *
+     * @return NULL, throws the guard file exceptions on the failures
+     */
+    static void write(GuardFile& file, size_t pos, const GuardRecord& record)
+    {
+        file.write(offset(pos), &record, copySize);
+    }
+
+    /**
+     * @brief Write the new record to the slot at the given position, which
+     *        may have a resolved record of the layout
+     *
+     * The whole slot is written so, the fields after the type are not
+     * kept from the previous record of the slot.
+     *
+     * @param[in] file GUARD file to write
+     * @param[in] pos position of the slot
+     * @param[in] record guard record in the GUARD file format
+     *
+     * @return NULL, throws the guard file exceptions on the failures
+     */
+    static void writeNew(GuardFile& file, size_t pos,
+                         const GuardRecord& record)
+    {
+        if constexpr (isNative)
+        {
+            write(file, pos, record);
+        }
+        else
+        {
+            uint8_t slot[recordSize];
+            memset(slot, 0xff, sizeof(slot));
+            memcpy(slot, &record, copySize);
+            file.write(offset(pos), slot, sizeof(slot));
+        }
+    }
+
+    /**
+     * @brief Check the record read from the slot is blank i.e. all 0xFF
+     */
+    static bool isBlank(const GuardRecord& record)
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&record);
+        return std::all_of(bytes, bytes + copySize,
+                           [](uint8_t byte) { return byte == 0xff; });
+    }
+
+    /**
+     * @brief Call the function with the slots before the first blank slot
+     *
+     * The slots are read a chunk at a time and classified by scanSlots()
+     * so, the function is called only with the slots which are not blank.
+     *
+     * @param[in] file GUARD file to read
+     * @param[in] key entity path to match the slots with, nullptr to not
+     *                match
+     * @param[in] func called with the position, the SlotClass and the
+     *                 content of the slot, returns false to stop
+     *
+     * @return NULL, throws the guard file exceptions on the failures
+     */
+    template <typename Func>
+    static void scan(GuardFile& file, const EntityPath* key, Func&& func)
+    {
+        uint8_t chunk[scanChunk * recordSize];
+        uint8_t classes[scanChunk];
+        size_t total = slots(file.size());
+        for (size_t pos = 0; pos < total; pos += scanChunk)
+        {
+            size_t count = std::min(scanChunk, total - pos);
+            file.read(offset(pos), chunk, count * recordSize);
+            stats::add(stats::counters.recordsScanned, count);
+            size_t used = scanSlots(chunk, count, recordSize, copySize, key,
+                                    classes);
+            for (size_t i = 0; i < used; i++)
+            {
+                if (!func(static_cast<int>(pos + i), classes[i],
+                          chunk + i * recordSize))
+                {
+                    return;
+                }
+            }
+            if (used < count)
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Read the guard record at the given position
+     *
+     * @param[in] file GUARD file to read
+     * @param[in] pos position of the guard record
+     * @param[out] record guard record in the GUARD file format
+     *
+     * @return the given position, -1 if the position is the end of the
+     *         guard records
+     */
+    static int next(GuardFile& file, int pos, GuardRecord& record)
+    {
+        if (offset(pos) + recordSize > file.size())
+        {
+            return -1;
+        }
+        read(file, pos, record);
+        stats::add(stats::counters.recordsScanned);
+        if (isBlank(record))
+        {
+            return -1;
+        }
+        return pos;
+    }
+};
+
+/**
+ * @brief Call the function with the codec of the layout
+ *
+ * @param[in] layout layout of the GUARD file
+ * @param[in] func generic function called with RecordCodec<> of the layout
+ *
+ * @return the return value of the function
+ */
+template <typename Func>
+decltype(auto) withCodec(GuardLayout layout, Func&& func)
+{
+    if (layout == GuardLayout::PGuard)
+    {
+        return func(RecordCodec<PGuardLayout>());
+    }
+    return func(RecordCodec<StandardLayout>());
+}
+
+/**
+ * @brief Call the function with every guard record of the GUARD file, up
+ *        to the first blank slot
+ *
+ * @param[in] file GUARD file to read
+ * @param[in] func called with the guard record in the GUARD file format
+ *                 and its position
+ *
+ * @return NULL, throws the guard file exceptions on the failures
+ */
+template <typename Func>
+void forEachRecord(GuardFile& file, Func&& func)
+{
+    withCodec(file.layout(), [&](auto codec) {
+        using Codec = decltype(codec);
+        GuardRecord record;
+        Codec::scan(file, nullptr, [&](int pos, uint8_t, const uint8_t* slot) {
+            Codec::decode(slot, record);
+            func(record, pos);
+            return true;
+        });
+    });
+}
+} // namespace guard
+} // namespace openpower
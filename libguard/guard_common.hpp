@@ -5,6 +5,7 @@
 #include "guard_log.hpp"
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 
@@ -36,6 +37,16 @@ struct EntityPath
     using PathElements = std::array<PathElement, maxPathElements>;
     PathElements pathElements;
 
+    /**
+     * @brief Return true if the number of the path elements is within
+     *        maxPathElements, the entity path which is not valid is not
+     *        equal to any other
+     */
+    bool isValid() const
+    {
+        return (type_size & 0x0F) <= maxPathElements;
+    }
+
     bool operator==(const EntityPath& a) const
     {
         if ((a.type_size & 0x0F) != (type_size & 0x0F))
@@ -48,7 +59,7 @@ struct EntityPath
             return false;
         }
 
-        if ((a.type_size & 0x0F) > maxPathElements)
+        if (!a.isValid())
         {
             return false;
         }
@@ -74,7 +85,7 @@ struct EntityPath
     {
         if (rawData.size() > sizeof(EntityPath))
         {
-            openpower::guard::log::guard_log(
+            GUARD_LOG(
                 GUARD_ERROR,
                 "Size mismatch. Given buf size[%d] EntityPath sizeof[%d]",
                 rawData.size(), sizeof(EntityPath));
@@ -84,8 +95,7 @@ struct EntityPath
 
         if (rawData.size() == 0)
         {
-            openpower::guard::log::guard_log(GUARD_ERROR,
-                                             "Given raw data is empty");
+            GUARD_LOG(GUARD_ERROR, "Given raw data is empty");
             throw InvalidEntityPath(
                 "EntityPath initializer_list constructor failed");
         }
@@ -94,7 +104,7 @@ struct EntityPath
 
         if ((type_size & 0x0F) != ((rawData.size() - 1) / sizeof(PathElement)))
         {
-            openpower::guard::log::guard_log(
+            GUARD_LOG(
                 GUARD_ERROR, "PathElement size mismatch in given raw data");
             throw InvalidEntityPath(
                 "EntityPath initializer_list constructor failed");
@@ -107,7 +117,7 @@ struct EntityPath
             if (std::distance(it, rawData.end()) <
                 static_cast<int>(sizeof(PathElement)))
             {
-                openpower::guard::log::guard_log(
+                GUARD_LOG(
                     GUARD_ERROR,
                     "Insufficient data for PathElement in given raw data");
                 throw InvalidEntityPath(
@@ -123,14 +133,13 @@ struct EntityPath
     {
         if (rawData == nullptr || maxBufSize == 0)
         {
-            openpower::guard::log::guard_log(GUARD_ERROR,
-                                             "Given raw data is empty");
+            GUARD_LOG(GUARD_ERROR, "Given raw data is empty");
             throw InvalidEntityPath("EntityPath conversion constructor failed");
         }
 
         if (maxBufSize > sizeof(EntityPath))
         {
-            openpower::guard::log::guard_log(
+            GUARD_LOG(
                 GUARD_ERROR,
                 "Size mismatch. Given buf size[%d] EntityPath sizeof[%d]",
                 maxBufSize, sizeof(EntityPath));
@@ -145,7 +154,7 @@ struct EntityPath
 
         if (pathElementsSize > maxElements)
         {
-            openpower::guard::log::guard_log(
+            GUARD_LOG(
                 GUARD_ERROR,
                 "PathElement size %d max elements size %d mismatch "
                 "in given raw data",
@@ -163,5 +172,47 @@ struct EntityPath
     }
 } __attribute__((__packed__));
 
+/**
+ * @brief Hash function object for EntityPath
+ *
+ * Only type_size and the path elements in use are hashed, so the result
+ * is consistent with EntityPath::operator== and EntityPath can be used
+ * as key in the unordered containers.
+ */
+struct EntityPathHash
+{
+    size_t operator()(const EntityPath& entityPath) const noexcept
+    {
+        return static_cast<size_t>(fnv1a(entityPath));
+    }
+
+    /**
+     * @brief Return the 64-bit FNV-1a of the significant bytes of the
+     *        entity path, independent of the size of size_t
+     */
+    static uint64_t fnv1a(const EntityPath& entityPath) noexcept
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        auto mix = [&hash](uint8_t byte) {
+            hash ^= byte;
+            hash *= 0x100000001b3ULL;
+        };
+
+        mix(entityPath.type_size);
+        int pathElementsSize = entityPath.type_size & 0x0F;
+        if (pathElementsSize > EntityPath::maxPathElements)
+        {
+            pathElementsSize = EntityPath::maxPathElements;
+        }
+        for (int i = 0; i < pathElementsSize; i++)
+        {
+            mix(entityPath.pathElements[i].targetType);
+            mix(entityPath.pathElements[i].instance);
+        }
+
+        return hash;
+    }
+};
+
 } // namespace guard
 } // namespace openpower
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_crc.hpp"
+
+#include <endian.h>
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace openpower
+{
+namespace guard
+{
+namespace
+{
+/**
+ * The CRC is computed on the inverted value in the implementations below,
+ * the callers invert it before and after.
+ */
+using Crc32cFunc = uint32_t (*)(const uint8_t* data, size_t size,
+                                uint32_t crc);
+
+// Reflected CRC32C polynomial
+constexpr uint32_t crc32cPoly = 0x82F63B78;
+
+using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+/**
+ * @brief Build the tables to compute the CRC of 8 bytes at once, table
+ *        N is the CRC of a byte followed by N zero bytes
+ */
+constexpr Crc32cTables makeCrc32cTables()
+{
+    Crc32cTables tables{};
+    for (uint32_t byte = 0; byte < 256; byte++)
+    {
+        uint32_t crc = byte;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? crc32cPoly : 0);
+        }
+        tables[0][byte] = crc;
+    }
+    for (size_t table = 1; table < tables.size(); table++)
+    {
+        for (uint32_t byte = 0; byte < 256; byte++)
+        {
+            uint32_t crc = tables[table - 1][byte];
+            tables[table][byte] = (crc >> 8) ^ tables[0][crc & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr Crc32cTables crc32cTables = makeCrc32cTables();
+
+uint32_t crc32cTable(const uint8_t* data, size_t size, uint32_t crc)
+{
+    const auto& t = crc32cTables;
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        word = le64toh(word) ^ crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^
+              t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF] ^
+              t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+              t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+        data += sizeof(word);
+    }
+    for (; size > 0; size--)
+    {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t
+    crc32cSse42(const uint8_t* data, size_t size, uint32_t crc)
+{
+    uint64_t crc64 = crc;
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += sizeof(word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; size > 0; size--)
+    {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+uint32_t crc32cArm(const uint8_t* data, size_t size, uint32_t crc)
+{
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+        data += sizeof(word);
+    }
+    for (; size > 0; size--)
+    {
+        crc = __crc32cb(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+Crc32cFunc selectCrc32c()
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return crc32cSse42;
+    }
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    return crc32cArm;
+#endif
+    return crc32cTable;
+}
+} // namespace
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc)
+{
+    static const Crc32cFunc func = selectCrc32c();
+    return ~func(static_cast<const uint8_t*>(data), size, ~crc);
+}
+
+uint32_t crc32cPortable(const void* data, size_t size, uint32_t crc)
+{
+    return ~crc32cTable(static_cast<const uint8_t*>(data), size, ~crc);
+}
+} // namespace guard
+} // namespace openpower
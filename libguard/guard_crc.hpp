@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace openpower
+{
+namespace guard
+{
+/**
+ * @brief Compute the CRC32C (Castagnoli) of the buffer
+ *
+ * Uses the CRC32 instructions of SSE4.2 if the CPU supports them, or of
+ * ARMv8 if libguard is built for a CPU with them, otherwise the portable
+ * table based implementation.
+ *
+ * @param[in] data buffer to compute the CRC of
+ * @param[in] size size of the buffer
+ * @param[in] crc CRC of the preceding data to continue with, 0 to start
+ *
+ * @return CRC32C of the buffer
+ */
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+/**
+ * @brief Compute the CRC32C of the buffer without the CPU instructions,
+ *        same result as crc32c()
+ */
+uint32_t crc32cPortable(const void* data, size_t size, uint32_t crc = 0);
+} // namespace guard
+} // namespace openpower
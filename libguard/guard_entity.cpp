@@ -9,11 +9,14 @@
 #include "phal_devtree.hpp"
 #endif /* DEV_TREE */
 
+#include <cstring>
+#include <unordered_map>
+
 namespace openpower
 {
 namespace guard
 {
-std::optional<EntityPath> getEntityPath(const std::string& physicalPath)
+std::optional<EntityPath> getEntityPath(std::string_view physicalPath)
 {
 #ifdef DEV_TREE
 
@@ -36,7 +39,7 @@ std::optional<std::string> getPhysicalPath(const EntityPath& entityPath)
     return openpower::guard::phal::getPhysicalPathFromDevTree(entityPath);
 
 #else  // from custom list
-    for (auto i : physicalEntityPathMap)
+    for (const auto& i : physicalEntityPathMap)
     {
         if (i.second == entityPath)
         {
@@ -47,6 +50,76 @@ std::optional<std::string> getPhysicalPath(const EntityPath& entityPath)
 #endif /* DEV_TREE */
 }
 
+std::optional<size_t> copyPhysicalPath(const EntityPath& entityPath, char* buf,
+                                       size_t size)
+{
+#ifdef DEV_TREE
+
+    return openpower::guard::phal::copyPhysicalPathFromDevTree(entityPath,
+                                                               buf, size);
+
+#else  // from custom list
+    for (const auto& i : physicalEntityPathMap)
+    {
+        if (i.second == entityPath)
+        {
+            if (i.first.size() < size)
+            {
+                memcpy(buf, i.first.c_str(), i.first.size() + 1);
+            }
+            return i.first.size();
+        }
+    }
+    return std::nullopt;
+#endif /* DEV_TREE */
+}
+
+std::vector<std::optional<std::string>>
+    resolvePhysicalPaths(const std::vector<EntityPath>& entityPaths)
+{
+#ifdef DEV_TREE
+
+    return openpower::guard::phal::getPhysicalPathsFromDevTree(entityPaths);
+
+#else  // from custom list
+    // Single pass over the list to find all the given entity paths
+    std::unordered_map<EntityPath, const std::string*, EntityPathHash>
+        physicalPaths;
+    for (const auto& entityPath : entityPaths)
+    {
+        physicalPaths.emplace(entityPath, nullptr);
+    }
+
+    size_t pending = physicalPaths.size();
+    for (auto it = physicalEntityPathMap.begin();
+         (it != physicalEntityPathMap.end()) && (pending > 0); ++it)
+    {
+        auto found = physicalPaths.find(it->second);
+        if ((found != physicalPaths.end()) && (found->second == nullptr))
+        {
+            found->second = &it->first;
+            pending--;
+        }
+    }
+
+    std::vector<std::optional<std::string>> resolvedPaths;
+    resolvedPaths.reserve(entityPaths.size());
+    for (const auto& entityPath : entityPaths)
+    {
+        const std::string* physicalPath = physicalPaths[entityPath];
+        if (physicalPath != nullptr)
+        {
+            resolvedPaths.emplace_back(*physicalPath);
+        }
+        else
+        {
+            resolvedPaths.emplace_back(std::nullopt);
+        }
+    }
+    return resolvedPaths;
+#endif /* DEV_TREE */
+}
+
 std::optional<std::string> pathTypeToString(const int pType)
 {
     auto i = PathType.find(pType);
@@ -3,6 +3,8 @@
 #include "guard_common.hpp"
 #include <attributes_info.H>
 #include <map>
+#include <string_view>
+#include <vector>
 
 namespace openpower
 {
@@ -36,8 +38,11 @@ const static reason guardreason = {
  * @return NULL if entity path not found else entity path
  *              computed from physical path
  *
+ * @note The lookup does not allocate, so callers holding the path in
+ *       a std::string, a string literal or a raw buffer can pass it
+ *       without building a temporary std::string.
  */
-std::optional<EntityPath> getEntityPath(const std::string& physicalPath);
+std::optional<EntityPath> getEntityPath(std::string_view physicalPath);
 
 /**
  * @brief Return physical path computed from  entity path
@@ -48,6 +53,35 @@ std::optional<EntityPath> getEntityPath(const std::string& physicalPath);
  */
 std::optional<std::string> getPhysicalPath(const EntityPath& entityPath);
 
+/**
+ * @brief Copy physical path computed from entity path into the given buffer
+ *
+ * Same as getPhysicalPath() but, the physical path is not allocated.
+ *
+ * @param[in] entityPath entity path
+ * @param[out] buf buffer to copy the NULL terminated physical path, not
+ *                 changed if the physical path does not fit
+ * @param[in] size size of the buffer
+ * @return NULL if physical path is not found else length of the physical
+ *         path without the NULL terminator, the physical path is copied
+ *         only if the length is less than the buffer size
+ */
+std::optional<size_t> copyPhysicalPath(const EntityPath& entityPath, char* buf,
+                                       size_t size);
+
+/**
+ * @brief Return physical paths computed from the given entity paths
+ *
+ * Used to resolve the set of entity paths in one pass instead of one
+ * getPhysicalPath() call per entity path, e.g. to list guard records.
+ *
+ * @param[in] entityPaths entity paths to resolve
+ * @return physical paths in the same order as the given entity paths,
+ *         NULL for the entity paths which are not found
+ */
+std::vector<std::optional<std::string>>
+    resolvePhysicalPaths(const std::vector<EntityPath>& entityPaths);
+
 /**
  * @brief Return string value for corresponding path type
  *
@@ -2,13 +2,16 @@
 #pragma once
 #include "guard_common.hpp"
 
+#include <functional>
 #include <map>
+#include <string>
 
 namespace openpower
 {
 namespace guard
 {
-using PhysicalEntityPathMap = std::map<std::string, EntityPath>;
+// std::less<> enables heterogeneous lookup by std::string_view
+using PhysicalEntityPathMap = std::map<std::string, EntityPath, std::less<>>;
 const static PhysicalEntityPathMap physicalEntityPathMap = {
     {"/sys-0", {0x21, 0x01, 0x00}},
     {"/sys-0/node-0/bmc-0", {0x23, 0x01, 0x00, 0x02, 0x00, 0x3A, 0x00}},
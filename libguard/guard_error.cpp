@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_error.hpp"
+
+#include "guard_exception.hpp"
+
+#include <filesystem>
+#include <new>
+#include <string>
+
+namespace openpower
+{
+namespace guard
+{
+using namespace openpower::guard::exception;
+
+/**
+ * @class GuardErrorCategory
+ *
+ * Category of the libguard errors
+ */
+class GuardErrorCategory : public std::error_category
+{
+  public:
+    const char* name() const noexcept override
+    {
+        return "guard";
+    }
+
+    std::string message(int error) const override
+    {
+        switch (static_cast<GuardError>(error))
+        {
+            case GuardError::InvalidGuardFile:
+                return "Invalid guard file";
+            case GuardError::GuardFileOpenFailed:
+                return "Failed to open guard file";
+            case GuardError::GuardFileReadFailed:
+                return "Failed to read from guard file";
+            case GuardError::GuardFileWriteFailed:
+                return "Failed to write to the guard file";
+            case GuardError::GuardFileSeekFailed:
+                return "Failed to move to the position in the guard file";
+            case GuardError::InvalidEntry:
+                return "Invalid parameter";
+            case GuardError::AlreadyGuarded:
+                return "Guard record is already exist";
+            case GuardError::InvalidEntityPath:
+                return "Guard record not found";
+            case GuardError::CannotDelete:
+                return "Cannot delete a non-core system generated guard record";
+            case GuardError::GuardFileOverFlowed:
+                return "Enough size is not available in GUARD file";
+        }
+        return "Unknown guard error";
+    }
+};
+
+const std::error_category& guardErrorCategory() noexcept
+{
+    static const GuardErrorCategory category;
+    return category;
+}
+
+std::error_code make_error_code(GuardError error) noexcept
+{
+    return {static_cast<int>(error), guardErrorCategory()};
+}
+
+void throwGuardError(const std::error_code& ec)
+{
+    if (ec.category() != guardErrorCategory())
+    {
+        if (ec == std::errc::not_enough_memory)
+        {
+            throw std::bad_alloc();
+        }
+        throw std::system_error(ec);
+    }
+
+    auto message = ec.message();
+    switch (static_cast<GuardError>(ec.value()))
+    {
+        case GuardError::InvalidGuardFile:
+            throw InvalidGuardFile(message);
+        case GuardError::GuardFileOpenFailed:
+            throw GuardFileOpenFailed(message);
+        case GuardError::GuardFileReadFailed:
+            throw GuardFileReadFailed(message);
+        case GuardError::GuardFileWriteFailed:
+            throw GuardFileWriteFailed(message);
+        case GuardError::GuardFileSeekFailed:
+            throw GuardFileSeekFailed(message);
+        case GuardError::InvalidEntry:
+            throw InvalidEntry(message);
+        case GuardError::AlreadyGuarded:
+            throw AlreadyGuarded(message);
+        case GuardError::InvalidEntityPath:
+            throw InvalidEntityPath(message);
+        case GuardError::CannotDelete:
+            throw CannotDelete(message);
+        case GuardError::GuardFileOverFlowed:
+            throw GuardFileOverFlowed(message);
+    }
+    throw GuardException(message);
+}
+
+std::error_code currentErrorCode() noexcept
+{
+    try
+    {
+        throw;
+    }
+    catch (const InvalidGuardFile&)
+    {
+        return GuardError::InvalidGuardFile;
+    }
+    catch (const GuardFileOpenFailed&)
+    {
+        return GuardError::GuardFileOpenFailed;
+    }
+    catch (const GuardFileReadFailed&)
+    {
+        return GuardError::GuardFileReadFailed;
+    }
+    catch (const GuardFileWriteFailed&)
+    {
+        return GuardError::GuardFileWriteFailed;
+    }
+    catch (const GuardFileSeekFailed&)
+    {
+        return GuardError::GuardFileSeekFailed;
+    }
+    catch (const InvalidEntry&)
+    {
+        return GuardError::InvalidEntry;
+    }
+    catch (const AlreadyGuarded&)
+    {
+        return GuardError::AlreadyGuarded;
+    }
+    catch (const InvalidEntityPath&)
+    {
+        return GuardError::InvalidEntityPath;
+    }
+    catch (const CannotDelete&)
+    {
+        return GuardError::CannotDelete;
+    }
+    catch (const GuardFileOverFlowed&)
+    {
+        return GuardError::GuardFileOverFlowed;
+    }
+    catch (const std::bad_alloc&)
+    {
+        return std::make_error_code(std::errc::not_enough_memory);
+    }
+    catch (const std::system_error& ex)
+    {
+        // Includes std::filesystem::filesystem_error
+        return ex.code();
+    }
+    catch (...)
+    {
+        return std::make_error_code(std::errc::io_error);
+    }
+}
+} // namespace guard
+} // namespace openpower
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <system_error>
+#include <type_traits>
+
+namespace openpower
+{
+namespace guard
+{
+/**
+ * @brief Errors of libguard, one for each exception in guard_exception.hpp
+ *
+ * Reported by the std::error_code variants of the APIs, which are not
+ * throwing the exceptions.
+ */
+enum class GuardError
+{
+    InvalidGuardFile = 1,
+    GuardFileOpenFailed,
+    GuardFileReadFailed,
+    GuardFileWriteFailed,
+    GuardFileSeekFailed,
+    InvalidEntry,
+    AlreadyGuarded,
+    InvalidEntityPath,
+    CannotDelete,
+    GuardFileOverFlowed
+};
+
+/**
+ * @brief Return the error category of libguard errors
+ *
+ * @return the error category
+ */
+const std::error_category& guardErrorCategory() noexcept;
+
+/**
+ * @brief Return the error code of the given libguard error
+ *
+ * @param[in] error libguard error
+ *
+ * @return error code
+ */
+std::error_code make_error_code(GuardError error) noexcept;
+
+/**
+ * @brief Throw the exception of the given error code
+ *
+ * @param[in] ec error code of the failure
+ *
+ * @return Does not return, throws the exception from guard_exception.hpp
+ *         for the libguard errors, std::bad_alloc for the memory failure
+ *         and std::system_error for the rest.
+ */
+[[noreturn]] void throwGuardError(const std::error_code& ec);
+
+/**
+ * @brief Return the error code of the exception being handled
+ *
+ * @return error code
+ *
+ * @note Must be called from a catch block
+ */
+std::error_code currentErrorCode() noexcept;
+} // namespace guard
+} // namespace openpower
+
+namespace std
+{
+template <>
+struct is_error_code_enum<openpower::guard::GuardError> : true_type
+{
+};
+} // namespace std
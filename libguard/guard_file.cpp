@@ -4,9 +4,13 @@
 
 #include "guard_exception.hpp"
 #include "guard_log.hpp"
+#include "guard_stats.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cstring>
-#include <fstream>
 
 namespace openpower
 {
@@ -15,53 +19,58 @@ namespace guard
 using namespace openpower::guard::log;
 using namespace openpower::guard::exception;
 
-GuardFile::GuardFile(const fs::path& file) : guardFile(file)
+GuardFile::GuardFile(const fs::path& file) : GuardFile(file.c_str())
+{
+}
+
+GuardFile::GuardFile(const fs::path& file, GuardLayout layout) :
+    GuardFile(file.c_str())
 {
-    try
+    fileLayout = layout;
+}
+
+GuardFile::GuardFile(const char* file)
+{
+    fd = open(file, O_RDWR | O_CLOEXEC);
+    if (fd >= 0)
     {
-        std::ifstream file(guardFile, std::ios::in | std::ios::binary);
-        if (!file.good())
-        {
-            guard_log(GUARD_ERROR,
-                      "Failed to open the GUARD file during initailization");
-            throw GuardFileOpenFailed(
-                "Exception thrown as failed to open the guard file");
-        }
-        file.seekg(0, file.end);
-        if (file.fail())
-        {
-            guard_log(GUARD_ERROR,
-                      "Failed to move to last position in guard file");
-            throw GuardFileSeekFailed(
-                "Exception thrown as failed to move to the "
-                "last position in the file");
-        }
-        fileSize = file.tellg();
+        writable = true;
     }
-    catch (openpower::guard::exception::GuardFileOpenFailed& ex)
+    else if ((errno == EACCES) || (errno == EROFS))
     {
-        throw GuardFileOpenFailed(ex.what());
+        // Read only partition, write will fail
+        fd = open(file, O_RDONLY | O_CLOEXEC);
     }
-    catch (openpower::guard::exception::GuardFileSeekFailed& ex)
+    stats::add(stats::counters.opens);
+    if (fd < 0)
+    {
+        GUARD_LOG(GUARD_ERROR,
+                  "Failed to open the GUARD file during initailization");
+        throw GuardFileOpenFailed(
+            "Exception thrown as failed to open the guard file");
+    }
+
+    off_t end = lseek(fd, 0, SEEK_END);
+    if (end < 0)
     {
-        throw GuardFileSeekFailed(ex.what());
+        GUARD_LOG(GUARD_ERROR, "Failed to move to last position in guard file");
+        close(fd);
+        throw GuardFileSeekFailed("Exception thrown as failed to move to the "
+                                  "last position in the file");
     }
+    fileSize = end;
+}
+
+GuardFile::~GuardFile()
+{
+    close(fd);
 }
 
 void GuardFile::read(const uint64_t pos, void* dst, const uint64_t len)
 {
-    std::ifstream file(guardFile, std::ios::in | std::ios::binary);
-    if (!file.good())
+    if (pos > fileSize)
     {
-        guard_log(GUARD_ERROR,
-                  "Unable to open the guard file during read operation.");
-        throw GuardFileOpenFailed(
-            "Failed to open guard file in read function.");
-    }
-    file.seekg(pos, file.beg);
-    if (file.fail())
-    {
-        guard_log(GUARD_ERROR,
+        GUARD_LOG(GUARD_ERROR,
                   "Unable to move to the position in the guard file at"
                   " position= 0x%016llx",
                   pos);
@@ -69,10 +78,40 @@ void GuardFile::read(const uint64_t pos, void* dst, const uint64_t len)
             "Failed to move"
             "to the position during read operation in the guard file");
     }
-    file.read(reinterpret_cast<char*>(dst), len);
-    if (file.fail())
+
+    if (image != nullptr)
+    {
+        if (len > fileSize - pos)
+        {
+            GUARD_LOG(GUARD_ERROR,
+                      "Unable to read from guard file at position= 0x%016llx",
+                      pos);
+            throw GuardFileReadFailed("Failed to read from guard file.");
+        }
+        memcpy(dst, image + pos, len);
+        return;
+    }
+
+    auto* buf = static_cast<char*>(dst);
+    uint64_t done = 0;
+    while (done < len)
+    {
+        ssize_t rc = pread(fd, buf + done, len - done, pos + done);
+        if ((rc < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if (rc <= 0)
+        {
+            break;
+        }
+        done += rc;
+    }
+    stats::add(stats::counters.reads);
+    stats::add(stats::counters.bytesRead, done);
+    if (done != len)
     {
-        guard_log(GUARD_ERROR,
+        GUARD_LOG(GUARD_ERROR,
                   "Unable to read from guard file at position= 0x%016llx", pos);
         throw GuardFileReadFailed("Failed to read from guard file.");
     }
@@ -81,33 +120,47 @@ void GuardFile::read(const uint64_t pos, void* dst, const uint64_t len)
 
 void GuardFile::write(const uint64_t pos, const void* src, const uint64_t len)
 {
-    std::fstream file(guardFile,
-                      std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.good())
+    if (!writable)
     {
-        guard_log(
+        GUARD_LOG(
             GUARD_ERROR,
             "Unable to open guard file while perfoming the write operation");
         throw GuardFileOpenFailed("Failed to open guard file to write");
     }
 
-    file.seekp(pos, file.beg);
-    if (file.fail())
+    if (image != nullptr)
     {
-        guard_log(GUARD_ERROR,
-                  "Unable to move to the position in the guard file."
-                  " Position= 0x%016llx",
-                  pos);
-        throw GuardFileSeekFailed("Failed to move to the position during write "
-                                  "operation in the guard file.");
+        if ((pos > fileSize) || (len > fileSize - pos))
+        {
+            GUARD_LOG(GUARD_ERROR, "Unable to write the record to GUARD file.");
+            throw GuardFileWriteFailed("Failed to write to the guard file.");
+        }
+        memcpy(image + pos, src, len);
+        return;
     }
 
-    file.write(reinterpret_cast<const char*>(src), len);
-    if (file.fail())
+    const auto* buf = static_cast<const char*>(src);
+    uint64_t done = 0;
+    while (done < len)
     {
-        guard_log(GUARD_ERROR, "Unable to write the record to GUARD file.");
+        ssize_t rc = pwrite(fd, buf + done, len - done, pos + done);
+        if ((rc < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if (rc <= 0)
+        {
+            break;
+        }
+        done += rc;
+    }
+    stats::add(stats::counters.writes);
+    if (done != len)
+    {
+        GUARD_LOG(GUARD_ERROR, "Unable to write the record to GUARD file.");
         throw GuardFileWriteFailed("Failed to write to the guard file.");
     }
+    stats::add(stats::counters.bytesWritten, len);
     return;
 }
 
@@ -118,7 +171,7 @@ void GuardFile::erase(const uint64_t pos, const uint64_t len)
     memset(buf, ~0, sizeof(buf));
     if (len <= 0)
     {
-        guard_log(GUARD_ERROR, "Length passed is %d which is not valid", len);
+        GUARD_LOG(GUARD_ERROR, "Length passed is %d which is not valid", len);
         throw InvalidEntry("Not a valid length value");
     }
 
@@ -131,9 +184,39 @@ void GuardFile::erase(const uint64_t pos, const uint64_t len)
     return;
 }
 
+void GuardFile::setImage(uint8_t* fileImage)
+{
+    image = fileImage;
+}
+
+void GuardFile::sync()
+{
+    if (image != nullptr)
+    {
+        return;
+    }
+    stats::add(stats::counters.fsyncs);
+    if (fdatasync(fd) != 0)
+    {
+        GUARD_LOG(GUARD_ERROR, "Unable to sync the GUARD file, errno: %d",
+                  errno);
+        throw GuardFileWriteFailed("Failed to sync the guard file.");
+    }
+}
+
 uint32_t GuardFile::size()
 {
     return fileSize;
 }
+
+void GuardFile::setLayout(GuardLayout layout)
+{
+    fileLayout = layout;
+}
+
+GuardLayout GuardFile::layout() const
+{
+    return fileLayout;
+}
 } // namespace guard
 } // namespace openpower
@@ -1,5 +1,9 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
+#include "include/guard_record.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 
 namespace openpower
@@ -11,12 +15,16 @@ namespace fs = std::filesystem;
  * @class GuardFile
  *
  * Cater for performing read/write operations on the guard file
+ *
+ * The file is opened once by the constructor and, the operations are
+ * done with pread/pwrite on the descriptor so, no stream buffer is
+ * allocated for every read and write.
  */
 class GuardFile
 {
   public:
     GuardFile() = delete;
-    ~GuardFile() = default;
+    ~GuardFile();
     GuardFile(const GuardFile&) = delete;
     GuardFile& operator=(const GuardFile&) = delete;
     GuardFile(GuardFile&&) = delete;
@@ -31,6 +39,25 @@ class GuardFile
      */
     explicit GuardFile(const fs::path& file);
 
+    /**
+     * @brief Constructor
+     *
+     * Same as above for the NULL terminated path, the path is not copied.
+     *
+     * @param[in] file GUARD file path
+     */
+    explicit GuardFile(const char* file);
+
+    /**
+     * @brief Constructor
+     *
+     * Same as above for the GUARD file of the known layout.
+     *
+     * @param[in] file GUARD file path
+     * @param[in] layout layout of the GUARD file
+     */
+    GuardFile(const fs::path& file, GuardLayout layout);
+
     /**
      * @brief Check the file exists or not in the pnor partition.
      *
@@ -77,6 +104,27 @@ class GuardFile
      */
     void erase(const uint64_t pos, const uint64_t len);
 
+    /**
+     * @brief Serve the reads and the writes from the given image of the
+     *        guard file instead of the file
+     *
+     * Used to apply many operations on the guard file and write only the
+     * changed parts to the file at the end.
+     *
+     * @param[in] fileImage content of the guard file, the size must be
+     *                      the file size. nullptr to use the file again.
+     * @return NULL
+     */
+    void setImage(uint8_t* fileImage);
+
+    /**
+     * @brief Flush the written guard data to the storage
+     *
+     * @return NULL on success
+     * 			Throw GuardFileWriteFailed exception on failure.
+     */
+    void sync();
+
     /**
      * @brief Return size of guard file
      *
@@ -84,9 +132,73 @@ class GuardFile
      */
     uint32_t size();
 
+    /**
+     * @brief Set the layout of the guard file, as detected from the file
+     *
+     * @param[in] layout layout of the guard file
+     * @return NULL
+     */
+    void setLayout(GuardLayout layout);
+
+    /**
+     * @brief Return the layout of the guard file, the layout of the build
+     *        unless it is set
+     */
+    GuardLayout layout() const;
+
   private:
-    fs::path guardFile;
+    int fd = -1;
+    bool writable = false;
+    GuardLayout fileLayout = defaultGuardLayout;
     uint32_t fileSize = 0;
+    uint8_t* image = nullptr;
 };
+
+/**
+ * @brief Call the function for every changed part of the image
+ *
+ * The changes which are closer than the given gap are reported together,
+ * so the caller can write them at once.
+ *
+ * @param[in] original content before the changes
+ * @param[in] image content after the changes
+ * @param[in] size size of the contents
+ * @param[in] maxGap unchanged bytes allowed in a part
+ * @param[in] func called with the start and the end offset of the part
+ *
+ * @return NULL
+ */
+template <typename Func>
+void forEachChange(const uint8_t* original, const uint8_t* image, size_t size,
+                   size_t maxGap, Func&& func)
+{
+    size_t pos = 0;
+    while (pos < size)
+    {
+        if (image[pos] == original[pos])
+        {
+            pos++;
+            continue;
+        }
+
+        size_t start = pos;
+        size_t end = pos + 1;
+        size_t gap = 0;
+        for (pos = end; (pos < size) && (gap < maxGap); pos++)
+        {
+            if (image[pos] != original[pos])
+            {
+                end = pos + 1;
+                gap = 0;
+            }
+            else
+            {
+                gap++;
+            }
+        }
+        func(start, end);
+        pos = end;
+    }
+}
 } // namespace guard
 } // namespace openpower
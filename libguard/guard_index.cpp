@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_index.hpp"
+
+#include "guard_codec.hpp"
+#include "guard_common.hpp"
+#include "guard_file.hpp"
+#include "guard_interface.hpp"
+#include "guard_interface_impl.hpp"
+
+#include <endian.h>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+namespace openpower
+{
+namespace guard
+{
+GuardIndex::GuardIndex()
+{
+    refresh();
+}
+
+void GuardIndex::refresh()
+{
+    guardFile = getGuardFilePath();
+    layout = getGuardLayout();
+    GuardFile file(guardFile, layout);
+
+    ids.clear();
+    types.clear();
+    targets.clear();
+    hashes.clear();
+    slots.clear();
+    withCodec(layout, [&](auto codec) {
+        using Codec = decltype(codec);
+        ids.reserve(Codec::slots(file.size()));
+        Codec::scan(file, nullptr, [&](int pos, uint8_t,
+                                       const uint8_t* slotData) {
+            if constexpr (Codec::isNative)
+            {
+                GuardRecord record;
+                Codec::decode(slotData, record);
+                if (!isRecordIntact(record))
+                {
+                    return true;
+                }
+            }
+
+            uint32_t recordId;
+            EntityPath targetId;
+            memcpy(&recordId, slotData + offsetof(GuardRecord, recordId),
+                   sizeof(recordId));
+            memcpy(&targetId, slotData + offsetof(GuardRecord, targetId),
+                   sizeof(targetId));
+            ids.push_back(be32toh(recordId));
+            types.push_back(slotData[offsetof(GuardRecord, errType)]);
+            targets.push_back(targetId.isValid()
+                                  ? getTargetType(targetId)
+                                  : ENUM_ATTR_TYPE_NA);
+            hashes.push_back(hash(targetId));
+            slots.push_back(pos);
+            return true;
+        });
+    });
+}
+
+size_t GuardIndex::countUnresolved(bool persistentTypeOnly) const
+{
+    size_t count = 0;
+    for (size_t entry = 0; entry < ids.size(); entry++)
+    {
+        count += (ids[entry] != GUARD_RESOLVED) &&
+                 !(persistentTypeOnly && isEphemeralType(types[entry]));
+    }
+    return count;
+}
+
+std::vector<size_t> GuardIndex::filterByType(uint8_t errType) const
+{
+    std::vector<size_t> entries;
+    for (size_t entry = 0; entry < ids.size(); entry++)
+    {
+        if ((types[entry] == errType) && (ids[entry] != GUARD_RESOLVED))
+        {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+std::vector<size_t> GuardIndex::filterByTarget(ATTR_TYPE_Enum targetType) const
+{
+    std::vector<size_t> entries;
+    for (size_t entry = 0; entry < ids.size(); entry++)
+    {
+        if ((targets[entry] == targetType) && (ids[entry] != GUARD_RESOLVED))
+        {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+int GuardIndex::find(const EntityPath& entityPath) const
+{
+    uint64_t key = hash(entityPath);
+    if (key == 0)
+    {
+        return -1;
+    }
+
+    std::optional<GuardFile> file;
+    for (size_t entry = 0; entry < hashes.size(); entry++)
+    {
+        if ((hashes[entry] != key) || (ids[entry] == GUARD_RESOLVED))
+        {
+            continue;
+        }
+        if (!file)
+        {
+            file.emplace(guardFile, layout);
+        }
+        GuardRecord record;
+        withCodec(layout, [&](auto codec) {
+            codec.read(*file, slots[entry], record);
+        });
+        if (record.targetId == entityPath)
+        {
+            return static_cast<int>(entry);
+        }
+    }
+    return -1;
+}
+
+int GuardIndex::find(uint32_t recordId) const
+{
+    if (recordId == GUARD_RESOLVED)
+    {
+        return -1;
+    }
+    auto it = std::find(ids.begin(), ids.end(), recordId);
+    return (it == ids.end()) ? -1 : static_cast<int>(it - ids.begin());
+}
+
+GuardRecord GuardIndex::get(size_t entry) const
+{
+    GuardFile file(guardFile, layout);
+    GuardRecord record;
+    withCodec(layout,
+              [&](auto codec) { codec.read(file, slots.at(entry), record); });
+    return getHostEndiannessRecord(record);
+}
+
+uint64_t GuardIndex::hash(const EntityPath& entityPath)
+{
+    if (!entityPath.isValid())
+    {
+        return 0;
+    }
+
+    uint64_t value = EntityPathHash::fnv1a(entityPath);
+    return (value == 0) ? 1 : value;
+}
+} // namespace guard
+} // namespace openpower
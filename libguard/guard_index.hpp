@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "guard_entity.hpp"
+#include "include/guard_record.hpp"
+
+#include <attributes_info.H>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace openpower
+{
+namespace guard
+{
+namespace fs = std::filesystem;
+
+/**
+ * @class GuardIndex
+ *
+ * In-memory index of the guard records of the guard file in use, with one
+ * array per field which is used to filter, count and look up the records
+ * i.e. the record id, the type, the target type and the hash of the
+ * target. Those arrays are walked instead of the guard records, which are
+ * mostly the FRU VPD and the padding, and the guard record is read from
+ * the guard file only when it is asked for by get().
+ *
+ * The entries are the records of getAll(), in the same order, the
+ * resolved records included. The index is the snapshot of the guard file
+ * when it is built or refreshed, it is not updated by the changes of the
+ * guard records after that, see GuardWatcher to know when to refresh.
+ */
+class GuardIndex
+{
+  public:
+    /**
+     * @brief Constructor, builds the index of the guard file in use i.e.
+     *        libguard_init() must be called already
+     *
+     * Throws the guard file exceptions on the I/O failures.
+     */
+    GuardIndex();
+
+    /**
+     * @brief Read the guard records of the guard file in use again
+     *
+     * @return NULL, throws the guard file exceptions on the I/O failures
+     */
+    void refresh();
+
+    /**
+     * @brief Return the number of the entries, resolved records included
+     */
+    size_t size() const
+    {
+        return ids.size();
+    }
+
+    /**
+     * @brief Return the number of the records which are not resolved
+     *
+     * @param[in] persistentTypeOnly skip the ephemeral records
+     *
+     * @return number of the records
+     */
+    size_t countUnresolved(bool persistentTypeOnly = false) const;
+
+    /**
+     * @brief Return the entries of the records of the type which are not
+     *        resolved
+     *
+     * @param[in] errType type of the guard record, see GardType
+     *
+     * @return entries in the index order
+     */
+    std::vector<size_t> filterByType(uint8_t errType) const;
+
+    /**
+     * @brief Return the entries of the records of the target type which
+     *        are not resolved
+     *
+     * @param[in] targetType type of the target, see getTargetType()
+     *
+     * @return entries in the index order
+     */
+    std::vector<size_t> filterByTarget(ATTR_TYPE_Enum targetType) const;
+
+    /**
+     * @brief Find the record of the target which is not resolved
+     *
+     * The candidates are found by the hash of the target and, the target
+     * is compared against the guard file only for them.
+     *
+     * @param[in] entityPath entity path of the target
+     *
+     * @return entry of the record, -1 if it is not found. Throws the guard
+     *         file exceptions on the I/O failures.
+     */
+    int find(const EntityPath& entityPath) const;
+
+    /**
+     * @brief Find the record of the record id
+     *
+     * @param[in] recordId id of the guard record
+     *
+     * @return entry of the record, -1 if it is not found
+     */
+    int find(uint32_t recordId) const;
+
+    /**
+     * @brief Read the guard record of the entry from the guard file
+     *
+     * @param[in] entry entry of the index, less than size()
+     *
+     * @return guard record in host endianness format, as of the guard
+     *         file now. Throws the guard file exceptions on the I/O
+     *         failures.
+     */
+    GuardRecord get(size_t entry) const;
+
+    /**
+     * @brief Return the hash of the entity path, the entity paths which are
+     *        equal have the same hash, see EntityPathHash
+     *
+     * @param[in] entityPath entity path to hash
+     *
+     * @return 64-bit hash of the entity path, 0 if it is not valid
+     */
+    static uint64_t hash(const EntityPath& entityPath);
+
+    /**
+     * @brief Return the record ids of the entries in host endianness,
+     *        GUARD_RESOLVED for the resolved records
+     */
+    const std::vector<uint32_t>& recordIds() const
+    {
+        return ids;
+    }
+
+    /**
+     * @brief Return the types of the records of the entries
+     */
+    const std::vector<uint8_t>& errTypes() const
+    {
+        return types;
+    }
+
+    /**
+     * @brief Return the target types of the entries, see getTargetType()
+     */
+    const std::vector<uint8_t>& targetTypes() const
+    {
+        return targets;
+    }
+
+    /**
+     * @brief Return the hashes of the targets of the entries, see hash()
+     */
+    const std::vector<uint64_t>& pathHashes() const
+    {
+        return hashes;
+    }
+
+  private:
+    fs::path guardFile;
+    GuardLayout layout;
+
+    std::vector<uint32_t> ids;
+    std::vector<uint8_t> types;
+    std::vector<uint8_t> targets;
+    std::vector<uint64_t> hashes;
+    std::vector<uint32_t> slots; ///< Slot positions in the guard file
+};
+} // namespace guard
+} // namespace openpower
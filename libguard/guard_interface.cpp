@@ -3,11 +3,16 @@
 
 #include "guard_interface.hpp"
 
+#include "guard_codec.hpp"
 #include "guard_common.hpp"
+#include "guard_crc.hpp"
 #include "guard_entity.hpp"
+#include "guard_error.hpp"
 #include "guard_exception.hpp"
 #include "guard_file.hpp"
+#include "guard_interface_impl.hpp"
 #include "guard_log.hpp"
+#include "guard_stats.hpp"
 #include "include/guard_record.hpp"
 
 #ifdef DEV_TREE
@@ -16,7 +21,11 @@
 
 #include <attributes_info.H>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
+#include <optional>
+#include <string_view>
 #include <variant>
 
 namespace openpower
@@ -25,45 +34,140 @@ namespace guard
 {
 
 using namespace openpower::guard::log;
-using guardRecordParam = std::variant<EntityPath, uint32_t>;
 using namespace openpower::guard::exception;
 
 static fs::path guardFilePath = "";
+static GuardLayout guardLayout = defaultGuardLayout;
 
-#ifdef PGUARD
-static constexpr size_t headerSize = 0;
-#else
-static constexpr size_t headerSize = 16;
-#endif
+/**
+ * @brief Return true if the type is one of GardType which Hostboot and
+ *        libguard create the guard records with
+ */
+static bool isKnownType(uint8_t errType)
+{
+    switch (errType)
+    {
+        case GARD_Spare:
+        case GARD_User_Manual:
+        case GARD_Unrecoverable:
+        case GARD_Fatal:
+        case GARD_Predictive:
+        case GARD_Power:
+        case GARD_PHYP:
+        case GARD_Reconfig:
+        case GARD_Sticky_deconfig:
+            return true;
+    }
+    return false;
+}
 
-void initialize()
+/**
+ * @brief Return true if the first slots of the layout have guard records
+ *
+ * The fields common to the layouts are checked i.e. the record id is not
+ * zero, the target has 1 to EntityPath::maxPathElements elements and, the
+ * type is known, up to the first blank slot.
+ *
+ * @param[in] head content of the start of the GUARD file
+ * @param[in] headSize size of the content
+ *
+ * @return false if a slot is not a guard record or, the first slot is
+ *         blank
+ */
+template <typename Layout>
+static bool hasRecords(const uint8_t* head, size_t headSize)
 {
-    if (guardFilePath.empty())
+    constexpr size_t fieldsSize = offsetof(GuardRecord, errType) + 1;
+    size_t records = 0;
+    for (size_t offset = Layout::headerSize; offset + fieldsSize <= headSize;
+         offset += Layout::recordSize)
     {
-        if (!fs::exists(GUARD_PRSV_PATH))
+        const uint8_t* slot = head + offset;
+        if (std::all_of(slot, slot + fieldsSize,
+                        [](uint8_t byte) { return byte == 0xff; }))
         {
-            std::string exceptionLog("Guard file does not exist at ");
-            exceptionLog += GUARD_PRSV_PATH;
-            throw InvalidGuardFile(exceptionLog);
+            break;
         }
-        guardFilePath = GUARD_PRSV_PATH;
+
+        uint32_t recordId;
+        EntityPath targetId;
+        memcpy(&recordId, slot + offsetof(GuardRecord, recordId),
+               sizeof(recordId));
+        memcpy(&targetId, slot + offsetof(GuardRecord, targetId),
+               sizeof(targetId));
+        if ((recordId == 0) || ((targetId.type_size & 0x0F) == 0) ||
+            !targetId.isValid() ||
+            !isKnownType(slot[offsetof(GuardRecord, errType)]))
+        {
+            return false;
+        }
+        records++;
     }
-    if (fs::file_size(guardFilePath) == 0)
+    return records > 0;
+}
+
+namespace impl
+{
+GuardLayout detectLayout(GuardFile& file)
+{
+    // The first slots of both the layouts are read, the first slot of the
+    // PGUARD layout covers the header of the standard layout
+    uint8_t head[StandardLayout::headerSize + 4 * StandardLayout::recordSize];
+    size_t headSize = std::min<size_t>(file.size(), sizeof(head));
+    file.read(0, head, headSize);
+
+    size_t magicSize = sizeof(GuardRecord_t::iv_magicNumber);
+    if ((headSize >= magicSize) &&
+        (strncmp((char*)head, GUARD_MAGIC, magicSize) == 0))
     {
-        std::string exceptionLog("Empty Guard file ");
-        exceptionLog += GUARD_PRSV_PATH;
-        throw InvalidGuardFile(exceptionLog);
+        return GuardLayout::Standard;
     }
-#ifndef PGUARD
+
+    // The layout is known from the records if the header is damaged or
+    // missing, the standard layout is checked first as its slots are
+    // further apart
+    if (hasRecords<StandardLayout>(head, headSize))
+    {
+        GUARD_LOG(GUARD_ERROR,
+                  "Guard records without the header, using the standard "
+                  "layout");
+        return GuardLayout::Standard;
+    }
+    if (hasRecords<PGuardLayout>(head, headSize))
+    {
+        // Records without the header are written by Hostboot in the
+        // PGUARD layout
+        return GuardLayout::PGuard;
+    }
+
+    if (!std::all_of(head, head + headSize,
+                     [](uint8_t byte) { return byte == 0xff; }))
+    {
+        GUARD_LOG(GUARD_ERROR,
+                  "Guard file has neither the header nor the guard records, "
+                  "using the layout of the build");
+    }
+    // Blank partition is formatted in the layout of the build
+    return defaultGuardLayout;
+}
+
+void initializeHeader(GuardFile& file)
+{
+    file.setLayout(detectLayout(file));
+    if (file.layout() != GuardLayout::Standard)
+    {
+        return;
+    }
+
     // validate magic number, read from 0th position
     GuardRecord_t guardRecord;
-    GuardFile file(guardFilePath);
-    file.read(0, &guardRecord, sizeof(guardRecord));
+    file.read(0, &guardRecord.iv_magicNumber,
+              sizeof(guardRecord.iv_magicNumber));
     if (strncmp((char*)guardRecord.iv_magicNumber, GUARD_MAGIC,
                 sizeof(guardRecord.iv_magicNumber)) != 0)
     {
         size_t headerPos = 8;
-        guard_log(
+        GUARD_LOG(
             GUARD_INFO,
             "Updating magic number and guard version to the GUARD partition.");
         memcpy((char*)guardRecord.iv_magicNumber, GUARD_MAGIC,
@@ -74,14 +178,37 @@ void initialize()
         file.write(headerPos, &guardRecord.iv_version,
                    sizeof(guardRecord.iv_version));
     }
-#endif
+}
+} // namespace impl
+
+void initialize()
+{
+    if (guardFilePath.empty())
+    {
+        if (!fs::exists(GUARD_PRSV_PATH))
+        {
+            std::string exceptionLog("Guard file does not exist at ");
+            exceptionLog += GUARD_PRSV_PATH;
+            throw InvalidGuardFile(exceptionLog);
+        }
+        guardFilePath = GUARD_PRSV_PATH;
+    }
+    if (fs::file_size(guardFilePath) == 0)
+    {
+        std::string exceptionLog("Empty Guard file ");
+        exceptionLog += GUARD_PRSV_PATH;
+        throw InvalidGuardFile(exceptionLog);
+    }
+    GuardFile file(guardFilePath);
+    impl::initializeHeader(file);
+    guardLayout = file.layout();
 }
 
 const fs::path& getGuardFilePath()
 {
     if (guardFilePath.empty())
     {
-        guard_log(GUARD_ERROR, "Guard file is not initialised.");
+        GUARD_LOG(GUARD_ERROR, "Guard file is not initialised.");
         throw GuardFileOpenFailed(
             "Guard file is not initialised. "
             "Please make sure libguard_init() is called already");
@@ -90,6 +217,11 @@ const fs::path& getGuardFilePath()
     return guardFilePath;
 }
 
+GuardLayout getGuardLayout()
+{
+    return guardLayout;
+}
+
 bool isEphemeralType(const uint8_t recordType)
 {
     if ((recordType == GARD_Reconfig) || (recordType == GARD_Sticky_deconfig))
@@ -102,81 +234,345 @@ bool isEphemeralType(const uint8_t recordType)
 
 bool isBlankRecord(const GuardRecord& guard)
 {
-    GuardRecord blankRecord;
-    memset(&blankRecord, 0xff, sizeof(guard));
-    return (memcmp(&blankRecord, &guard, sizeof(guard)) == 0);
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&guard);
+    return std::all_of(bytes, bytes + sizeof(guard),
+                       [](uint8_t byte) { return byte == 0xff; });
 }
 
 int guardNext(GuardFile& file, int pos, GuardRecord& guard)
 {
-    auto lenOfGuardRecord{sizeof(guard)};
-    uint32_t offset = (pos * lenOfGuardRecord) + headerSize;
-    uint32_t size = file.size();
+    return withCodec(file.layout(), [&](auto codec) {
+        return codec.next(file, pos, guard);
+    });
+}
 
-    // Validate the offset with the required bytes size before reading.
-    if (offset + lenOfGuardRecord > size)
+GuardRecord getHostEndiannessRecord(const GuardRecord& record)
+{
+    GuardRecord convertedRecord = record;
+    convertedRecord.recordId = be32toh(convertedRecord.recordId);
+    convertedRecord.elogId = be32toh(convertedRecord.elogId);
+    return convertedRecord;
+}
+
+#if defined(GUARD_RECORD_CRC) && !defined(PGUARD)
+// Offset of the checksum in the record, the bytes before are checked
+static constexpr size_t recordCrcPos =
+    sizeof(GuardRecord) - sizeof(GuardRecordCrc);
+static constexpr size_t recordCrcSize =
+    recordCrcPos + offsetof(GuardRecordCrc, crc);
+#endif
+
+void sealRecord([[maybe_unused]] GuardRecord& guard)
+{
+#if defined(GUARD_RECORD_CRC) && !defined(PGUARD)
+    auto* bytes = reinterpret_cast<uint8_t*>(&guard);
+    GuardRecordCrc recordCrc;
+    recordCrc.marker = GUARD_RECORD_CRC_MARKER;
+    memcpy(bytes + recordCrcPos, &recordCrc, sizeof(recordCrc.marker));
+    recordCrc.crc = htobe32(crc32c(bytes, recordCrcSize));
+    memcpy(bytes + recordCrcPos, &recordCrc, sizeof(recordCrc));
+#endif
+}
+
+/**
+ * @brief Set the checksum of the guard record before writing it to the
+ *        slot of the layout
+ *
+ * The checksum is in the padding, which is not written to the slots of the
+ * PGUARD layout.
+ *
+ * @param[in,out] guard guard record in the GUARD file format
+ *
+ * @return NULL
+ */
+template <typename Codec>
+static void sealSlot(GuardRecord& guard)
+{
+    if constexpr (Codec::isNative)
+    {
+        sealRecord(guard);
+    }
+}
+
+bool isRecordIntact([[maybe_unused]] const GuardRecord& guard)
+{
+#if defined(GUARD_RECORD_CRC) && !defined(PGUARD)
+    // The resolved records are not checked since Hostboot resolves the
+    // records without updating the checksum
+    if (guard.recordId == GUARD_RESOLVED)
     {
-        return -1;
+        return true;
     }
-    memset(&guard, 0, lenOfGuardRecord);
-    file.read(offset, &guard, lenOfGuardRecord);
-    if (isBlankRecord(guard))
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&guard);
+    GuardRecordCrc recordCrc;
+    memcpy(&recordCrc, bytes + recordCrcPos, sizeof(recordCrc));
+    if ((recordCrc.marker != GUARD_RECORD_CRC_MARKER) ||
+        (be32toh(recordCrc.crc) == crc32c(bytes, recordCrcSize)))
     {
-        return -1;
+        // Records without the checksum are written by Hostboot or by
+        // libguard built without the checksum
+        return true;
     }
-    return pos;
+
+    GUARD_LOG(GUARD_ERROR, "Guard record %u is corrupted, checksum mismatch",
+              be32toh(guard.recordId));
+    stats::add(stats::counters.checksumErrors);
+    return false;
+#else
+    return true;
+#endif
 }
 
+#if defined(DEV_TREE) && !defined(PGUARD)
 /**
- * @brief Helper function to return guard record in host
- *        endianess format
+ * @brief Helper function to fill the serial number and part number of
+ *        the FRU which contains the guarded target
  *
- * @param[in] record - bigendian record
+ * The FRU VPD is taken from the device tree physical path index so,
+ * the device tree is not traversed for every record.
  *
- * @return guard record in host endianness format
+ * @param[in,out] guard - guard record to fill the FRU VPD
  *
+ * @note The record is created without FRU VPD if it is not found
  */
-static GuardRecord getHostEndiannessRecord(const GuardRecord& record)
+static void fillFruVpd(GuardRecord& guard)
 {
-    GuardRecord convertedRecord = record;
-    convertedRecord.recordId = be32toh(convertedRecord.recordId);
-    convertedRecord.elogId = be32toh(convertedRecord.elogId);
-    return convertedRecord;
+    try
+    {
+        auto fruVpd = openpower::guard::phal::getFruVpdFromDevTree(
+            guard.targetId);
+        if (!fruVpd)
+        {
+            GUARD_LOG(GUARD_INFO, "FRU VPD is not found for the guard record");
+            return;
+        }
+        memcpy(guard.u.s1.serialNum, fruVpd->serialNum.data(),
+               sizeof(guard.u.s1.serialNum));
+        memcpy(guard.u.s1.partNum, fruVpd->partNum.data(),
+               sizeof(guard.u.s1.partNum));
+    }
+    catch (const std::exception& ex)
+    {
+        GUARD_LOG(GUARD_ERROR, "Failed to get FRU VPD, exception: %s",
+                  ex.what());
+    }
 }
+#endif
 
-#define for_each_guard(file, pos, guard)                                       \
-    for (pos = guardNext(file, 0, guard); pos >= 0;                            \
-         pos = guardNext(file, ++pos, guard))
+#ifdef GUARD_HEADER_EXT
+static_assert(sizeof(GuardHeaderExt) == sizeof(GuardRecord_t::iv_padding));
 
-GuardRecord create(const EntityPath& entityPath, uint32_t eId, uint8_t eType,
-                   bool overwriteRecord)
+/**
+ * @brief Read the header extension
+ *
+ * @param[in] file GUARD file to read
+ * @param[out] ext header extension in big endian
+ *
+ * @return true if the header extension is present, the values are not
+ *         validated against the records
+ */
+static bool readHeaderExt(GuardFile& file, GuardHeaderExt& ext)
+{
+    uint8_t buf[sizeof(GuardRecord_t::iv_version) + sizeof(ext)];
+    file.read(offsetof(GuardRecord_t, iv_version), buf, sizeof(buf));
+    memcpy(&ext, buf + sizeof(GuardRecord_t::iv_version), sizeof(ext));
+    return (buf[0] == CURRENT_GARD_VERSION_LAYOUT) &&
+           (ext.revision == GUARD_HEADER_EXT_REVISION);
+}
+
+/**
+ * @brief Write the header extension
+ *
+ * The header extension is written as not present if the values do not fit
+ * into it, so the readers scan the records.
+ *
+ * @param[in] file GUARD file to write
+ * @param[in] usedSlots number of slots before the first blank slot
+ * @param[in] resolvedSlots number of resolved slots in use
+ * @param[in] nextRecordId high-water mark of the record id
+ *
+ * @return NULL
+ */
+static void writeHeaderExt(GuardFile& file, uint32_t usedSlots,
+                           uint32_t resolvedSlots, uint32_t nextRecordId)
+{
+    GuardHeaderExt ext;
+    memset(&ext, 0xff, sizeof(ext));
+    if ((usedSlots <= UINT16_MAX) && (resolvedSlots <= UINT16_MAX) &&
+        (nextRecordId <= UINT16_MAX))
+    {
+        ext.revision = GUARD_HEADER_EXT_REVISION;
+        ext.usedSlots = htobe16(usedSlots);
+        ext.resolvedSlots = htobe16(resolvedSlots);
+        ext.nextRecordId = htobe16(nextRecordId);
+    }
+    else
+    {
+        GUARD_LOG(GUARD_INFO,
+                  "Header extension can not hold %u records or record id %u,"
+                  " falling back to scanning",
+                  usedSlots, nextRecordId);
+    }
+    file.write(offsetof(GuardRecord_t, iv_padding), &ext, sizeof(ext));
+}
+
+/**
+ * @brief Read all the used slots at once by using the header extension
+ *
+ * The header extension is not valid if Hostboot, which does not know it,
+ * added records after the used slots.
+ *
+ * @param[in] file GUARD file to read
+ * @param[out] records records in the GUARD file format
+ *
+ * @return false if the header extension is not present or valid
+ */
+template <typename Codec>
+static bool readRecordsByHeaderExt(GuardFile& file, GuardRecords& records)
+{
+    GuardHeaderExt ext;
+    if (!readHeaderExt(file, ext))
+    {
+        return false;
+    }
+
+    uint32_t slots = Codec::slots(file.size());
+    uint32_t usedSlots = be16toh(ext.usedSlots);
+    if (usedSlots > slots)
+    {
+        return false;
+    }
+    if (usedSlots < slots)
+    {
+        GuardRecord next;
+        Codec::read(file, usedSlots, next);
+        if (!Codec::isBlank(next))
+        {
+            return false;
+        }
+    }
+
+    records.resize(usedSlots);
+    if constexpr (Codec::isNative)
+    {
+        if (usedSlots > 0)
+        {
+            file.read(Codec::offset(0), records.data(),
+                      usedSlots * sizeof(GuardRecord));
+        }
+    }
+    else
+    {
+        std::vector<uint8_t> slotData(usedSlots * Codec::recordSize);
+        if (usedSlots > 0)
+        {
+            file.read(Codec::offset(0), slotData.data(), slotData.size());
+        }
+        for (uint32_t i = 0; i < usedSlots; i++)
+        {
+            Codec::decode(slotData.data() + i * Codec::recordSize,
+                          records[i]);
+        }
+    }
+    stats::add(stats::counters.recordsScanned, usedSlots);
+    for (const auto& record : records)
+    {
+        if (Codec::isBlank(record))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+namespace impl
 {
+void formatHeader(GuardFile& file, [[maybe_unused]] uint32_t usedSlots,
+                  [[maybe_unused]] uint32_t resolvedSlots,
+                  [[maybe_unused]] uint32_t nextRecordId)
+{
+    GuardRecord_t guardRecord;
+    memcpy(guardRecord.iv_magicNumber, GUARD_MAGIC,
+           sizeof(guardRecord.iv_magicNumber));
+    guardRecord.iv_version = CURRENT_GARD_VERSION_LAYOUT;
+    memset(guardRecord.iv_padding, 0xff, sizeof(guardRecord.iv_padding));
+    file.write(0, &guardRecord, StandardLayout::headerSize);
+#ifdef GUARD_HEADER_EXT
+    writeHeaderExt(file, usedSlots, resolvedSlots, nextRecordId);
+#endif
+}
+} // namespace impl
+
+/**
+ * @brief Read the records before the first blank slot
+ *
+ * @param[in] file GUARD file to read
+ * @param[out] records records in the GUARD file format
+ *
+ * @return NULL, throws the guard file exceptions on the I/O failures.
+ */
+template <typename Codec>
+static void readRecords(Codec, GuardFile& file, GuardRecords& records)
+{
+#ifdef GUARD_HEADER_EXT
+    if constexpr (Codec::hasHeader)
+    {
+        if (readRecordsByHeaderExt<Codec>(file, records))
+        {
+            return;
+        }
+        GUARD_LOG(GUARD_DEBUG,
+                  "Header extension is not valid, scanning records");
+        records.clear();
+    }
+#endif
+    Codec::scan(file, nullptr, [&](int, uint8_t, const uint8_t* slotData) {
+        Codec::decode(slotData, records.emplace_back());
+        return true;
+    });
+}
 
+namespace impl
+{
+template <typename Codec>
+static GuardRecord createRecord(Codec, GuardFile& file,
+                                const EntityPath& entityPath, uint32_t eId,
+                                uint8_t eType, bool overwriteRecord,
+                                std::error_code& ec)
+{
     //! check if guard record already exists
-    int pos = 0;
     int lastPos = 0;
-    uint32_t offset = 0;
+    int slot = 0;
     uint32_t avalSize = 0;
     uint32_t maxId = 0;
     uint32_t id = 0;
+    uint32_t resolvedSlots = 0;
     int empPos = -1;
     GuardRecord existGuard;
     GuardRecord guard;
     size_t sizeOfGuard = sizeof(guard);
     memset(&guard, 0xff, sizeOfGuard);
     memset(&existGuard, 0xff, sizeOfGuard);
+    std::optional<GuardRecord> result;
 
-    GuardFile file(guardFilePath);
-    for_each_guard(file, pos, existGuard)
-    {
+    // Only the matching slots are read as the guard record
+    Codec::scan(file, &entityPath, [&](int pos, uint8_t slotClass,
+                                       const uint8_t* slotData) {
         // Storing the oldest resolved guard record position.
-        if ((existGuard.recordId == GUARD_RESOLVED) && (empPos < 0))
+        if ((slotClass & SLOT_RESOLVED) && (empPos < 0))
         {
             empPos = pos;
         }
+        if (slotClass & SLOT_RESOLVED)
+        {
+            resolvedSlots++;
+        }
 
-        if (existGuard.targetId == entityPath)
+        if (slotClass & SLOT_MATCH)
         {
+            Codec::decode(slotData, existGuard);
             /**
              * - Ignore the existing record if resolved
              * - Ignore ephemeral records since the assumption is the host
@@ -189,7 +585,7 @@ GuardRecord create(const EntityPath& entityPath, uint32_t eId, uint8_t eType,
                 isEphemeralType(existGuard.errType))
             {
                 lastPos++;
-                continue;
+                return true;
             }
             else if (overwriteRecord)
             {
@@ -199,10 +595,10 @@ GuardRecord create(const EntityPath& entityPath, uint32_t eId, uint8_t eType,
                 {
                     // Override the existing manual guard if the given record
                     // type is Fatal or Predictive
-                    offset = lastPos * sizeOfGuard;
                     existGuard.errType = eType;
                     existGuard.elogId = htobe32(eId);
-                    file.write(offset + headerSize, &existGuard, sizeOfGuard);
+                    sealSlot<Codec>(existGuard);
+                    Codec::write(file, lastPos, existGuard);
                 }
                 else if ((existGuard.errType == GARD_Predictive) &&
                          ((eType == GARD_Fatal) ||
@@ -210,80 +606,172 @@ GuardRecord create(const EntityPath& entityPath, uint32_t eId, uint8_t eType,
                 {
                     // Override the existing Predictive guard if the given
                     // record type is Fatal
-                    offset = lastPos * sizeOfGuard;
                     existGuard.errType = eType;
                     existGuard.elogId = htobe32(eId);
-                    file.write(offset + headerSize, &existGuard, sizeOfGuard);
+                    sealSlot<Codec>(existGuard);
+                    Codec::write(file, lastPos, existGuard);
                 }
                 else
                 {
-                    guard_log(
+                    GUARD_LOG(
                         GUARD_ERROR,
                         "Failed to overwrite since record is already exist and "
                         "that does not meet the condition to overwrite");
-                    throw AlreadyGuarded(
-                        "Failed to overwrite, Guard record is already exist");
+                    ec = GuardError::AlreadyGuarded;
+                    result = guard;
+                    return false;
                 }
             }
             else
             {
-                guard_log(
+                GUARD_LOG(
                     GUARD_ERROR,
                     "Already guard record is available in the GUARD partition");
-                throw AlreadyGuarded("Guard record is already exist");
+                ec = GuardError::AlreadyGuarded;
+                result = guard;
+                return false;
             }
-            return getHostEndiannessRecord(existGuard);
+            result = getHostEndiannessRecord(existGuard);
+            return false;
         }
 
-        id = be32toh(existGuard.recordId);
+        uint32_t recordId;
+        memcpy(&recordId, slotData, sizeof(recordId));
+        id = be32toh(recordId);
         //! find the largest record ID
-        if ((id > maxId) && (existGuard.recordId != GUARD_RESOLVED))
+        if ((id > maxId) && (recordId != GUARD_RESOLVED))
         {
-            maxId = be32toh(existGuard.recordId);
+            maxId = id;
         }
         lastPos++;
+        return true;
+    });
+    if (result)
+    {
+        return *result;
     }
 
     // Space left in GUARD file before writing a new record
-    avalSize = file.size() - ((lastPos * sizeOfGuard) + headerSize);
+    avalSize = file.size() - Codec::offset(lastPos);
 
-    if (avalSize < sizeOfGuard)
+    if (avalSize < Codec::recordSize)
     {
         if (empPos < 0)
         {
-            guard_log(GUARD_ERROR,
+            GUARD_LOG(GUARD_ERROR,
                       "Guard file size is %db (in bytes) and space remaining "
                       "in the GUARD file is %db but, required %db to create "
                       "a record. Total records: %d\n",
-                      file.size(), avalSize, sizeOfGuard, lastPos);
-            throw GuardFileOverFlowed(
-                "Enough size is not available in GUARD file");
+                      file.size(), avalSize, Codec::recordSize, lastPos);
+            ec = GuardError::GuardFileOverFlowed;
+            return guard;
         }
         // No space is left and have invalid record present. Hence using that
         // slot to write new guard record.
-        offset = empPos * sizeOfGuard;
+        slot = empPos;
     }
     else
     {
-        offset = lastPos * sizeOfGuard;
+        slot = lastPos;
     }
 
-    guard.recordId = htobe32(maxId + 1);
+    id = maxId + 1;
+#ifdef GUARD_HEADER_EXT
+    if constexpr (Codec::hasHeader)
+    {
+        // Record ids are not reused after resolving, as long as the header
+        // extension is kept
+        GuardHeaderExt ext;
+        if (readHeaderExt(file, ext) && (be16toh(ext.nextRecordId) > id))
+        {
+            id = be16toh(ext.nextRecordId);
+        }
+    }
+#endif
+    guard.recordId = htobe32(id);
     guard.errType = eType;
     guard.targetId = entityPath;
     guard.elogId = htobe32(eId);
-    //! TODO:- Need to fetch details from device tree APIs i.e. serial
-    //! number and part number.
-    // For now initializing serial number and part number with 0.
 #ifndef PGUARD
-    memset(guard.u.s1.serialNum, 0, sizeof(guard.u.s1.serialNum));
-    memset(guard.u.s1.partNum, 0, sizeof(guard.u.s1.partNum));
+    // The FRU VPD is not in the slots of the PGUARD layout
+    if constexpr (Codec::isNative)
+    {
+        memset(guard.u.s1.serialNum, 0, sizeof(guard.u.s1.serialNum));
+        memset(guard.u.s1.partNum, 0, sizeof(guard.u.s1.partNum));
+#ifdef DEV_TREE
+        fillFruVpd(guard);
+#endif /* DEV_TREE */
+    }
+#endif
+    sealSlot<Codec>(guard);
+    Codec::writeNew(file, slot, guard);
+#ifdef GUARD_HEADER_EXT
+    if constexpr (Codec::hasHeader)
+    {
+        if (slot == lastPos)
+        {
+            lastPos++;
+        }
+        else
+        {
+            resolvedSlots--;
+        }
+        writeHeaderExt(file, lastPos, resolvedSlots, id + 1);
+    }
 #endif
-    file.write(offset + headerSize, &guard, sizeOfGuard);
 
     return getHostEndiannessRecord(guard);
 }
 
+GuardRecord createRecord(GuardFile& file, const EntityPath& entityPath,
+                         uint32_t eId, uint8_t eType, bool overwriteRecord,
+                         std::error_code& ec)
+{
+    return withCodec(file.layout(), [&](auto codec) {
+        return createRecord(codec, file, entityPath, eId, eType,
+                            overwriteRecord, ec);
+    });
+}
+} // namespace impl
+
+GuardRecord create(const EntityPath& entityPath, uint32_t eId, uint8_t eType,
+                   bool overwriteRecord, std::error_code& ec) noexcept
+{
+    stats::LatencyTimer timer(stats::Api::Create);
+    ec.clear();
+    try
+    {
+        GuardFile file(guardFilePath, guardLayout);
+        return impl::createRecord(file, entityPath, eId, eType,
+                                  overwriteRecord, ec);
+    }
+    catch (...)
+    {
+        ec = currentErrorCode();
+    }
+
+    GuardRecord guard;
+    memset(&guard, 0xff, sizeof(guard));
+    return guard;
+}
+
+GuardRecord create(const EntityPath& entityPath, uint32_t eId, uint8_t eType,
+                   bool overwriteRecord)
+{
+    // The exceptions of the guard file are thrown as is, only the expected
+    // failures are reported by the error code
+    stats::LatencyTimer timer(stats::Api::Create);
+    std::error_code ec;
+    GuardFile file(guardFilePath, guardLayout);
+    auto guard = impl::createRecord(file, entityPath, eId, eType,
+                                    overwriteRecord, ec);
+    if (ec)
+    {
+        throwGuardError(ec);
+    }
+    return guard;
+}
+
 GuardRecord create(std::vector<uint8_t> rawPath, uint32_t eId, uint8_t eType,
                    bool overwriteRecord)
 {
@@ -291,42 +779,189 @@ GuardRecord create(std::vector<uint8_t> rawPath, uint32_t eId, uint8_t eType,
                   overwriteRecord);
 }
 
-GuardRecords getAll(bool persistentTypeOnly)
+namespace impl
+{
+GuardRecords getAllRecords(GuardFile& file, bool persistentTypeOnly)
 {
     GuardRecords guardRecords;
-    GuardRecord curRecord;
-    int pos = 0;
-    GuardFile file(guardFilePath);
-    for_each_guard(file, pos, curRecord)
+    withCodec(file.layout(),
+              [&](auto codec) { readRecords(codec, file, guardRecords); });
+
+    size_t count = 0;
+    for (const auto& curRecord : guardRecords)
     {
         if (persistentTypeOnly && isEphemeralType(curRecord.errType))
         {
             continue;
         }
-        curRecord.recordId = be32toh(curRecord.recordId);
-        curRecord.elogId = be32toh(curRecord.elogId);
-        guardRecords.push_back(curRecord);
+        if (!isRecordIntact(curRecord))
+        {
+            continue;
+        }
+        guardRecords[count++] = getHostEndiannessRecord(curRecord);
     }
+    guardRecords.resize(count);
     return guardRecords;
 }
 
+GuardRecordSummaries getAllSummaries(GuardFile& file,
+                                     bool persistentTypeOnly,
+                                     std::pmr::memory_resource* resource)
+{
+    GuardRecordSummaries summaries(resource);
+    withCodec(file.layout(), [&](auto codec) {
+        using Codec = decltype(codec);
+        Codec::scan(file, nullptr, [&](int, uint8_t, const uint8_t* slotData) {
+            uint8_t errType = slotData[offsetof(GuardRecord, errType)];
+            if (persistentTypeOnly && isEphemeralType(errType))
+            {
+                return true;
+            }
+            if constexpr (Codec::isNative)
+            {
+                GuardRecord record;
+                Codec::decode(slotData, record);
+                if (!isRecordIntact(record))
+                {
+                    return true;
+                }
+            }
+
+            // Only the summary fields are read from the slot
+            uint32_t recordId;
+            uint32_t elogId;
+            EntityPath targetId;
+            memcpy(&recordId, slotData + offsetof(GuardRecord, recordId),
+                   sizeof(recordId));
+            memcpy(&elogId, slotData + offsetof(GuardRecord, elogId),
+                   sizeof(elogId));
+            memcpy(&targetId, slotData + offsetof(GuardRecord, targetId),
+                   sizeof(targetId));
+            summaries.push_back(
+                {be32toh(recordId), be32toh(elogId), targetId, errType});
+            return true;
+        });
+    });
+    return summaries;
+}
+} // namespace impl
+
+GuardRecords getAll(bool persistentTypeOnly, std::error_code& ec) noexcept
+{
+    stats::LatencyTimer timer(stats::Api::GetAll);
+    ec.clear();
+    try
+    {
+        GuardFile file(guardFilePath, guardLayout);
+        return impl::getAllRecords(file, persistentTypeOnly);
+    }
+    catch (...)
+    {
+        ec = currentErrorCode();
+    }
+    return {};
+}
+
+GuardRecords getAll(bool persistentTypeOnly)
+{
+    stats::LatencyTimer timer(stats::Api::GetAll);
+    GuardFile file(guardFilePath, guardLayout);
+    return impl::getAllRecords(file, persistentTypeOnly);
+}
+
+GuardRecordSummaries getAllSummaries(bool persistentTypeOnly,
+                                     std::pmr::memory_resource* resource,
+                                     std::error_code& ec) noexcept
+{
+    stats::LatencyTimer timer(stats::Api::GetAllSummaries);
+    ec.clear();
+    try
+    {
+        GuardFile file(guardFilePath, guardLayout);
+        return impl::getAllSummaries(file, persistentTypeOnly, resource);
+    }
+    catch (...)
+    {
+        ec = currentErrorCode();
+    }
+    return GuardRecordSummaries(resource);
+}
+
+GuardRecordSummaries getAllSummaries(bool persistentTypeOnly,
+                                     std::pmr::memory_resource* resource)
+{
+    stats::LatencyTimer timer(stats::Api::GetAllSummaries);
+    GuardFile file(guardFilePath, guardLayout);
+    return impl::getAllSummaries(file, persistentTypeOnly, resource);
+}
+
 /**
- * @brief To find the guard record based on recordId or entityPath
- *
- * @param[in] value (std::variant<EntityPath, uint32_t>)
- *
- * @return NULL on success.
- * 		   Throw following exceptions:
- * 		   -InvalidEntry
- * 		   -InvalidEntityPath
+ * @brief Helper function to get the guard records of the FRU
  *
+ * @return guard records of the FRU, throws the guard file exceptions on
+ *         the I/O failures.
  */
-static void invalidateRecord(const guardRecordParam& value, bool forceClear)
+static GuardRecords
+    findBySerialNumber([[maybe_unused]] std::string_view serialNumber)
+{
+    GuardRecords guardRecords;
+#ifndef PGUARD
+    uint8_t serialNum[sizeof(GuardRecord::uniqueId_t::ibm11S_t::serialNum)] =
+        {};
+    if (serialNumber.empty() || (serialNumber.size() > sizeof(serialNum)))
+    {
+        return guardRecords;
+    }
+    // Serial number is stored with NULL padding
+    memcpy(serialNum, serialNumber.data(), serialNumber.size());
+
+    GuardFile file(guardFilePath, guardLayout);
+    forEachRecord(file, [&](const GuardRecord& curRecord, int) {
+        if (memcmp(curRecord.u.s1.serialNum, serialNum, sizeof(serialNum)) !=
+            0)
+        {
+            return;
+        }
+        if (!isRecordIntact(curRecord))
+        {
+            return;
+        }
+        guardRecords.push_back(getHostEndiannessRecord(curRecord));
+    });
+#endif
+    return guardRecords;
+}
+
+GuardRecords getBySerialNumber(std::string_view serialNumber,
+                               std::error_code& ec) noexcept
+{
+    ec.clear();
+    try
+    {
+        return findBySerialNumber(serialNumber);
+    }
+    catch (...)
+    {
+        ec = currentErrorCode();
+    }
+    return {};
+}
+
+GuardRecords getBySerialNumber(std::string_view serialNumber)
+{
+    return findBySerialNumber(serialNumber);
+}
+
+namespace impl
+{
+template <typename Codec>
+static std::error_code invalidateRecord(Codec, GuardFile& file,
+                                        const guardRecordParam& value,
+                                        bool forceClear)
 {
-    int pos = 0;
     GuardRecord existGuard;
     bool found = false;
-    uint32_t offset = 0;
+    std::error_code ec;
     EntityPath entityPath = {};
     uint32_t recordPos = 0;
 
@@ -340,107 +975,245 @@ static void invalidateRecord(const guardRecordParam& value, bool forceClear)
     }
     else
     {
-        throw InvalidEntry(
-            "Invalid parameter passed to invalidate guard record");
+        GUARD_LOG(GUARD_ERROR,
+                  "Invalid parameter passed to invalidate guard record");
+        return GuardError::InvalidEntry;
     }
 
-    GuardFile file(guardFilePath);
-    for_each_guard(file, pos, existGuard)
-    {
-        if (((be32toh(existGuard.recordId) == recordPos) ||
-             (existGuard.targetId == entityPath)) &&
-            (existGuard.recordId != GUARD_RESOLVED))
+#ifdef GUARD_HEADER_EXT
+    // All the slots are scanned to recompute the header extension, the
+    // values in it may be stale e.g. after Hostboot added records
+    constexpr bool scanAll = Codec::hasHeader;
+#else
+    constexpr bool scanAll = false;
+#endif
+    uint32_t usedSlots = 0;
+    uint32_t resolvedSlots = 0;
+    uint32_t maxId = 0;
+
+    Codec::scan(file, &entityPath, [&](int pos, uint8_t slotClass,
+                                       const uint8_t* slotData) {
+        usedSlots++;
+        if (slotClass & SLOT_RESOLVED)
+        {
+            resolvedSlots++;
+            return true;
+        }
+
+        uint32_t recordId;
+        memcpy(&recordId, slotData, sizeof(recordId));
+        maxId = std::max(maxId, be32toh(recordId));
+        if (!found &&
+            ((be32toh(recordId) == recordPos) || (slotClass & SLOT_MATCH)))
         {
+            Codec::decode(slotData, existGuard);
             const ATTR_TYPE_Enum targetType =
                 openpower::guard::getTargetType(existGuard.targetId);
 
-            // throw exception only if not forceClear AND
+            // fail only if not forceClear AND
             // it's not a deletable type (manual or core guard)
             if (!forceClear && !(openpower::guard::isCore(targetType) ||
                                  existGuard.errType == GARD_User_Manual))
             {
-                throw CannotDelete(
-                    "Cannot delete a non-core system generated guard record");
+                ec = GuardError::CannotDelete;
+                return false;
             }
 
-            offset = pos * sizeof(existGuard);
             existGuard.recordId = GUARD_RESOLVED;
-            file.write(offset + headerSize, &existGuard, sizeof(existGuard));
+            sealSlot<Codec>(existGuard);
+            Codec::write(file, pos, existGuard);
+            resolvedSlots++;
             found = true;
-            break;
+            return scanAll;
+        }
+        return true;
+    });
+
+#ifdef GUARD_HEADER_EXT
+    if constexpr (Codec::hasHeader)
+    {
+        GuardHeaderExt ext;
+        if (found && readHeaderExt(file, ext))
+        {
+            writeHeaderExt(file, usedSlots, resolvedSlots,
+                           std::max<uint32_t>(be16toh(ext.nextRecordId),
+                                              maxId + 1));
         }
     }
+#endif
 
+    if (ec)
+    {
+        return ec;
+    }
     if (!found)
     {
-        guard_log(GUARD_ERROR, "Guard record not found");
-        throw InvalidEntityPath("Guard record not found");
+        GUARD_LOG(GUARD_ERROR, "Guard record not found");
+        return GuardError::InvalidEntityPath;
+    }
+    return {};
+}
+
+std::error_code invalidateRecord(GuardFile& file,
+                                 const guardRecordParam& value,
+                                 bool forceClear)
+{
+    return withCodec(file.layout(), [&](auto codec) {
+        return invalidateRecord(codec, file, value, forceClear);
+    });
+}
+} // namespace impl
+
+void clear(const EntityPath& entityPath, bool forceClear,
+           std::error_code& ec) noexcept
+{
+    stats::LatencyTimer timer(stats::Api::Clear);
+    try
+    {
+        GuardFile file(guardFilePath, guardLayout);
+        ec = impl::invalidateRecord(file, entityPath, forceClear);
+    }
+    catch (...)
+    {
+        ec = currentErrorCode();
     }
 }
 
 void clear(const EntityPath& entityPath, bool forceClear)
 {
-    auto path = entityPath;
-    invalidateRecord(path, forceClear);
+    stats::LatencyTimer timer(stats::Api::Clear);
+    GuardFile file(guardFilePath, guardLayout);
+    auto ec = impl::invalidateRecord(file, entityPath, forceClear);
+    if (ec)
+    {
+        throwGuardError(ec);
+    }
+}
+
+void clear(const uint32_t recordId, bool forceClear,
+           std::error_code& ec) noexcept
+{
+    stats::LatencyTimer timer(stats::Api::Clear);
+    try
+    {
+        GuardFile file(guardFilePath, guardLayout);
+        ec = impl::invalidateRecord(file, recordId, forceClear);
+    }
+    catch (...)
+    {
+        ec = currentErrorCode();
+    }
 }
 
 void clear(const uint32_t recordId, bool forceClear)
 {
-    auto id = recordId;
-    invalidateRecord(id, forceClear);
+    stats::LatencyTimer timer(stats::Api::Clear);
+    GuardFile file(guardFilePath, guardLayout);
+    auto ec = impl::invalidateRecord(file, recordId, forceClear);
+    if (ec)
+    {
+        throwGuardError(ec);
+    }
 }
 
 void clearAll()
 {
-    GuardFile file(guardFilePath);
+    GuardFile file(guardFilePath, guardLayout);
 
     file.erase(0, file.size());
 }
 
-void invalidateAll()
+namespace impl
+{
+template <typename Codec>
+static void invalidateAll(Codec, GuardFile& file)
 {
-    int pos = 0;
     GuardRecord existGuard;
-    uint32_t offset = 0;
+    bool empty = true;
+#ifdef GUARD_HEADER_EXT
+    uint32_t usedSlots = 0;
+    uint32_t resolvedSlots = 0;
+    uint32_t maxId = 0;
+#endif
 
-    memset(&existGuard, 0, sizeof(existGuard));
-    GuardFile file(guardFilePath);
-    file.read(0 + headerSize, &existGuard, sizeof(existGuard));
-    if (isBlankRecord(existGuard))
+    Codec::scan(file, nullptr, [&](int pos, uint8_t, const uint8_t* slotData) {
+        empty = false;
+        Codec::decode(slotData, existGuard);
+#ifdef GUARD_HEADER_EXT
+        usedSlots++;
+        if (existGuard.recordId != GUARD_RESOLVED)
+        {
+            maxId = std::max(maxId, be32toh(existGuard.recordId));
+        }
+#endif
+        const ATTR_TYPE_Enum targetType =
+            openpower::guard::getTargetType(existGuard.targetId);
+        if (openpower::guard::isCore(targetType))
+        {
+#ifdef GUARD_HEADER_EXT
+            if (existGuard.recordId == GUARD_RESOLVED)
+            {
+                resolvedSlots++;
+            }
+#endif
+            // There is a requirement to exclude cores when delete all
+            // deconfiguration records is attempted from GUI as well as CLI.
+            // This change is made as a part of spare core support.
+            return true;
+        }
+        existGuard.recordId = GUARD_RESOLVED;
+        sealSlot<Codec>(existGuard);
+        Codec::write(file, pos, existGuard);
+#ifdef GUARD_HEADER_EXT
+        resolvedSlots++;
+#endif
+        return true;
+    });
+
+    if (empty)
     {
-        guard_log(GUARD_INFO, "No GUARD records to clear");
+        GUARD_LOG(GUARD_INFO, "No GUARD records to clear");
+        return;
     }
-    else
+#ifdef GUARD_HEADER_EXT
+    if constexpr (Codec::hasHeader)
     {
-        for_each_guard(file, pos, existGuard)
+        GuardHeaderExt ext;
+        uint32_t nextRecordId = maxId + 1;
+        if (readHeaderExt(file, ext) &&
+            (be16toh(ext.nextRecordId) > nextRecordId))
         {
-            const ATTR_TYPE_Enum targetType =
-                openpower::guard::getTargetType(existGuard.targetId);
-            if (openpower::guard::isCore(targetType))
-            {
-                // There is a requirement to exclude cores when delete all
-                // deconfiguration records is attempted from GUI as well as CLI.
-                // This change is made as a part of spare core support.
-                continue;
-            }
-            offset = pos * sizeof(existGuard);
-            existGuard.recordId = GUARD_RESOLVED;
-            file.write(offset + headerSize, &existGuard, sizeof(existGuard));
+            nextRecordId = be16toh(ext.nextRecordId);
         }
+        writeHeaderExt(file, usedSlots, resolvedSlots, nextRecordId);
     }
+#endif
+}
+
+void invalidateAll(GuardFile& file)
+{
+    withCodec(file.layout(), [&](auto codec) { invalidateAll(codec, file); });
+}
+} // namespace impl
+
+void invalidateAll()
+{
+    stats::LatencyTimer timer(stats::Api::InvalidateAll);
+    GuardFile file(guardFilePath, guardLayout);
+    impl::invalidateAll(file);
 }
 
 void libguard_init(bool enableDevtree)
 {
     initialize();
-    guard_log(GUARD_DEBUG, "Device tree is set to %d", enableDevtree);
+    GUARD_LOG(GUARD_DEBUG, "Device tree is set to %d", enableDevtree);
 #ifdef DEV_TREE
 
     if (enableDevtree)
     {
-        openpower::guard::log::guard_log(GUARD_INFO,
-                                         "Using power system device tree");
-        openpower::guard::phal::initPHAL();
+        GUARD_LOG(GUARD_INFO, "Using power system device tree");
+        // Device tree will be initialised when it is needed for the first time
+        openpower::guard::phal::initPHALOnDemand();
     }
 
 #endif /* DEV_TREE */
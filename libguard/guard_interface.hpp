@@ -2,9 +2,13 @@
 #pragma once
 
 #include "guard_entity.hpp"
+#include "guard_error.hpp"
 #include "include/guard_record.hpp"
 
 #include <filesystem>
+#include <memory_resource>
+#include <string_view>
+#include <system_error>
 
 namespace openpower
 {
@@ -32,6 +36,9 @@ namespace fs = std::filesystem;
  *         -GuardFileReadFailed
  *         -GuardFileWriteFailed
  *
+ * @note The serial number and part number of the FRU which contains the
+ * guarded target are filled from device tree if it is enabled.
+ *
  * @note EntityPath provided conversion constructor so, same api can use to pass
  * array of uint8_t buffer and conversion constructor automatically will take
  * care conversion from raw data to EntityPath.
@@ -40,6 +47,22 @@ GuardRecord create(const EntityPath& entityPath, uint32_t eId = 0,
                    uint8_t eType = GARD_User_Manual,
                    bool overwriteRecord = true);
 
+/**
+ * @brief Create a guard record on the PNOR Partition file
+ *
+ * Same as the above create() but, the failure is reported by the error
+ * code instead of the exception so, it is cheap to handle the expected
+ * failures e.g. AlreadyGuarded.
+ *
+ * @param[out] ec GuardError on failure, which are same as the exceptions
+ *                of the above create(), cleared on success
+ *
+ * @return created guard record in host endianess format on success,
+ *         blank record on failure
+ */
+GuardRecord create(const EntityPath& entityPath, uint32_t eId, uint8_t eType,
+                   bool overwriteRecord, std::error_code& ec) noexcept;
+
 /**
  * @brief Create a guard record on the PNOR Partition file
  *
@@ -70,6 +93,9 @@ GuardRecord create(std::vector<uint8_t> rawPath, uint32_t eId = 0,
 /**
  * @brief Get all the guard records
  *
+ * The records which fail the checksum are skipped, if libguard is built
+ * with the record checksum.
+ *
  * @param[in] persistentTypeOnly - Used to decide whether wants to get all
  *                                 records or only persistent type records.
  *                                 By default, get all records.
@@ -82,6 +108,82 @@ GuardRecord create(std::vector<uint8_t> rawPath, uint32_t eId = 0,
  */
 GuardRecords getAll(bool persistentTypeOnly = false);
 
+/**
+ * @brief Get all the guard records
+ *
+ * Same as the above getAll() but, the failure is reported by the error
+ * code instead of the exception.
+ *
+ * @param[out] ec GuardError on failure, cleared on success
+ *
+ * @return GuardRecords List of Guard Records, empty on failure
+ */
+GuardRecords getAll(bool persistentTypeOnly, std::error_code& ec) noexcept;
+
+/**
+ * @brief Get the summaries of all the guard records
+ *
+ * Same records as getAll() but, only the fields to list them are copied,
+ * into the memory of the given resource. The listing tools can pass an
+ * arena e.g. std::pmr::monotonic_buffer_resource, which is released at
+ * once after the list is used.
+ *
+ * @param[in] persistentTypeOnly Used to get only persistent type records.
+ *                               By default, get all records.
+ * @param[in] resource memory resource of the returned vector
+ *
+ * @return summaries of the guard records, in the slot order.
+ *         On failure will throw the same exceptions as getAll()
+ */
+GuardRecordSummaries getAllSummaries(
+    bool persistentTypeOnly = false,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+/**
+ * @brief Get the summaries of all the guard records
+ *
+ * Same as the above getAllSummaries() but, the failure is reported by the
+ * error code instead of the exception.
+ *
+ * @param[out] ec GuardError on failure, cleared on success
+ *
+ * @return summaries of the guard records, empty on failure
+ */
+GuardRecordSummaries getAllSummaries(bool persistentTypeOnly,
+                                     std::pmr::memory_resource* resource,
+                                     std::error_code& ec) noexcept;
+
+/**
+ * @brief Get the guard records of the FRU with the given serial number
+ *
+ * The serial number of the FRU which contains the guarded target is
+ * stored in the guard record when it is created.
+ *
+ * @param[in] serialNumber - FRU serial number
+ *
+ * @return GuardRecords List of Guard Records of the FRU, both resolved
+ *         and unresolved. Empty if no records are found or the guard
+ *         record layout is not having the serial number.
+ *         On failure will throw below exceptions:
+ *         -GuardFileOpenFailed
+ *         -GuardFileSeekFailed
+ *         -GuardFileReadFailed
+ */
+GuardRecords getBySerialNumber(std::string_view serialNumber);
+
+/**
+ * @brief Get the guard records of the FRU with the given serial number
+ *
+ * Same as the above getBySerialNumber() but, the failure is reported by
+ * the error code instead of the exception.
+ *
+ * @param[out] ec GuardError on failure, cleared on success
+ *
+ * @return GuardRecords List of Guard Records of the FRU, empty on failure
+ */
+GuardRecords getBySerialNumber(std::string_view serialNumber,
+                               std::error_code& ec) noexcept;
+
 /**
  * @brief Clear the guard record
  *
@@ -101,6 +203,19 @@ GuardRecords getAll(bool persistentTypeOnly = false);
  */
 void clear(const EntityPath& entityPath, bool forceClear = false);
 
+/**
+ * @brief Clear the guard record
+ *
+ * Same as the above clear() but, the failure is reported by the error
+ * code instead of the exception so, it is cheap to handle the expected
+ * failures e.g. InvalidEntityPath if the record is not found.
+ *
+ * @param[out] ec GuardError on failure, which are same as the exceptions
+ *                of the above clear() and CannotDelete, cleared on success
+ */
+void clear(const EntityPath& entityPath, bool forceClear,
+           std::error_code& ec) noexcept;
+
 /**
  * @brief Clear the guard record based on given record id
  *
@@ -116,6 +231,17 @@ void clear(const EntityPath& entityPath, bool forceClear = false);
  */
 void clear(const uint32_t recordId, bool forceClear = false);
 
+/**
+ * @brief Clear the guard record based on given record id
+ *
+ * Same as the above clear() but, the failure is reported by the error
+ * code instead of the exception.
+ *
+ * @param[out] ec GuardError on failure, cleared on success
+ */
+void clear(const uint32_t recordId, bool forceClear,
+           std::error_code& ec) noexcept;
+
 /**
  * @brief Clear all the guard records
  *
@@ -151,7 +277,8 @@ void invalidateAll();
  *            initialize device tree or not, default is true.
  * @return void
  *
- * @note device tree initialization should happen once.
+ * @note device tree initialization is deferred until the first physical
+ *       path conversion and it will happen only once.
  */
 void libguard_init(bool enableDevtree = true);
 
@@ -166,6 +293,18 @@ void libguard_init(bool enableDevtree = true);
  */
 const fs::path& getGuardFilePath();
 
+/**
+ * @brief Used to get the layout of the guard file which is using by
+ *        libguard, detected by libguard_init()
+ *
+ * @return GuardLayout::Standard if the guard file has the "GUARDREC"
+ *         header, GuardLayout::PGuard if it has the records without the
+ *         header and, the layout of the build if it is blank.
+ *
+ * @note This function should call after libguard_init()
+ */
+GuardLayout getGuardLayout();
+
 /**
  * @brief Used to get to know whether the given guard type is
  *        ephemeral or not.
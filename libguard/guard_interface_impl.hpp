@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "guard_entity.hpp"
+#include "guard_file.hpp"
+#include "include/guard_record.hpp"
+
+#include <memory_resource>
+#include <system_error>
+#include <variant>
+
+namespace openpower
+{
+namespace guard
+{
+using guardRecordParam = std::variant<EntityPath, uint32_t>;
+
+/**
+ * @brief Check the guard record is blank i.e. all 0xFF
+ *
+ * @param[in] guard guard record to check
+ *
+ * @return true if blank
+ */
+bool isBlankRecord(const GuardRecord& guard);
+
+/**
+ * @brief Check the checksum of the guard record, if it is present
+ *
+ * The failures are logged and counted in GuardStats::checksumErrors.
+ *
+ * @param[in] guard guard record in the GUARD file format
+ *
+ * @return false if the checksum does not match, true if it matches or
+ *         the record does not have the checksum
+ */
+bool isRecordIntact(const GuardRecord& guard);
+
+/**
+ * @brief Set the checksum of the guard record, if libguard is built with
+ *        the record checksum
+ *
+ * The checksum is in the padding so, it is only for the records written
+ * to the slots of the standard layout.
+ *
+ * @param[in,out] guard guard record in the GUARD file format
+ *
+ * @return NULL
+ */
+void sealRecord(GuardRecord& guard);
+
+/**
+ * @brief Read the guard record at the given position
+ *
+ * @param[in] file GUARD file to read
+ * @param[in] pos position of the guard record
+ * @param[out] guard guard record in the GUARD file format
+ *
+ * @return the given position, -1 if the position is the end of the guard
+ *         records
+ */
+int guardNext(GuardFile& file, int pos, GuardRecord& guard);
+
+/**
+ * @brief Helper function to return guard record in host
+ *        endianess format
+ *
+ * @param[in] record - bigendian record
+ *
+ * @return guard record in host endianness format
+ */
+GuardRecord getHostEndiannessRecord(const GuardRecord& record);
+
+/**
+ * The guard record operations on the opened GUARD file, shared by the
+ * C++ API which opens the file for every call and, the C API which keeps
+ * the file open in the caller provided handle. None of them allocates
+ * on success, except getAllRecords().
+ */
+namespace impl
+{
+/**
+ * @brief Detect the layout of the GUARD file from its content
+ *
+ * @param[in] file GUARD file to check
+ *
+ * The layout of the records is checked if the "GUARDREC" header is not
+ * found so, the standard layout with a damaged header is not taken for
+ * the PGUARD layout.
+ *
+ * @return GuardLayout::Standard if the file has the "GUARDREC" header or
+ *         the standard records, GuardLayout::PGuard if it has the PGUARD
+ *         records and, the layout of the build otherwise e.g. if it is
+ *         blank. Throws the guard file exceptions on the I/O failures.
+ */
+GuardLayout detectLayout(GuardFile& file);
+
+/**
+ * @brief Set the layout of the GUARD file from its content and, update
+ *        the magic number and the version of the GUARD file if they are
+ *        not valid for the standard layout
+ *
+ * @param[in] file GUARD file to initialize
+ *
+ * @return NULL, throws the guard file exceptions on the I/O failures.
+ */
+void initializeHeader(GuardFile& file);
+
+/**
+ * @brief Write the header of the standard layout with the current
+ *        version and, the header extension if libguard is built with it
+ *
+ * @param[in] file GUARD file to update
+ * @param[in] usedSlots number of slots before the first blank slot
+ * @param[in] resolvedSlots number of resolved slots in use
+ * @param[in] nextRecordId high-water mark of the record id
+ *
+ * @return NULL, throws the guard file exceptions on the I/O failures.
+ */
+void formatHeader(GuardFile& file, uint32_t usedSlots,
+                  uint32_t resolvedSlots, uint32_t nextRecordId);
+
+/**
+ * @brief Helper function to create the guard record
+ *
+ * @return created guard record in host endianess format on success.
+ *         Set the error code for the expected failures, which are
+ *         AlreadyGuarded and GuardFileOverFlowed and, throws the guard
+ *         file exceptions on the I/O failures.
+ */
+GuardRecord createRecord(GuardFile& file, const EntityPath& entityPath,
+                         uint32_t eId, uint8_t eType, bool overwriteRecord,
+                         std::error_code& ec);
+
+/**
+ * @brief Get the guard records, see getAll()
+ *
+ * @param[in] file GUARD file to read
+ * @param[in] persistentTypeOnly skip the ephemeral records
+ *
+ * @return guard records in host endianness format, throws the guard file
+ *         exceptions on the I/O failures.
+ */
+GuardRecords getAllRecords(GuardFile& file, bool persistentTypeOnly);
+
+/**
+ * @brief Get the summaries of the guard records, see getAllSummaries()
+ *
+ * @param[in] file GUARD file to read
+ * @param[in] persistentTypeOnly skip the ephemeral records
+ * @param[in] resource memory resource of the returned vector
+ *
+ * @return summaries of the guard records, throws the guard file
+ *         exceptions on the I/O failures.
+ */
+GuardRecordSummaries getAllSummaries(GuardFile& file,
+                                     bool persistentTypeOnly,
+                                     std::pmr::memory_resource* resource);
+
+/**
+ * @brief To find the guard record based on recordId or entityPath
+ *
+ * @param[in] file GUARD file to update
+ * @param[in] value (std::variant<EntityPath, uint32_t>)
+ * @param[in] forceClear clear the system generated records of non-core
+ *
+ * @return empty error code on success.
+ * 		   Following errors on failure:
+ * 		   -InvalidEntry
+ * 		   -InvalidEntityPath
+ * 		   -CannotDelete
+ * 		   Throws the guard file exceptions on the I/O failures.
+ */
+std::error_code invalidateRecord(GuardFile& file,
+                                 const guardRecordParam& value,
+                                 bool forceClear);
+
+/**
+ * @brief Invalidate all the guard records except the core records
+ *
+ * @param[in] file GUARD file to update
+ *
+ * @return NULL, throws the guard file exceptions on the I/O failures.
+ */
+void invalidateAll(GuardFile& file);
+} // namespace impl
+} // namespace guard
+} // namespace openpower
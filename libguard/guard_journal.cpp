@@ -0,0 +1,489 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_journal.hpp"
+
+#include "guard_crc.hpp"
+#include "guard_error.hpp"
+#include "guard_exception.hpp"
+#include "guard_interface.hpp"
+#include "guard_interface_impl.hpp"
+#include "guard_log.hpp"
+#include "guard_stats.hpp"
+
+#include <endian.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace openpower
+{
+namespace guard
+{
+using namespace openpower::guard::log;
+using namespace openpower::guard::exception;
+
+namespace
+{
+/**
+ * @class ImageScope
+ *
+ * Serve the guard file operations from the image in the scope
+ */
+class ImageScope
+{
+  public:
+    ImageScope(GuardFile& file, uint8_t* image) : file(file)
+    {
+        file.setImage(image);
+    }
+
+    ~ImageScope()
+    {
+        file.setImage(nullptr);
+    }
+
+    ImageScope(const ImageScope&) = delete;
+    ImageScope& operator=(const ImageScope&) = delete;
+
+  private:
+    GuardFile& file;
+};
+
+/**
+ * @brief Write the whole buffer to the file at the given position
+ *
+ * @return false on failure, errno is set
+ */
+bool writeAll(int fd, const void* src, size_t len, off_t pos)
+{
+    const auto* buf = static_cast<const uint8_t*>(src);
+    size_t done = 0;
+    while (done < len)
+    {
+        ssize_t rc = pwrite(fd, buf + done, len - done, pos + done);
+        if ((rc < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if (rc <= 0)
+        {
+            return false;
+        }
+        done += rc;
+    }
+    return true;
+}
+
+/**
+ * @brief Apply the changed parts of a journal entry to the image
+ *
+ * @param[in] changes changed parts of the journal entry
+ * @param[in] size size of the changed parts
+ * @param[in,out] image image to apply to, nullptr to only validate
+ * @param[in] imageSize size of the image
+ *
+ * @return false if the changed parts are not valid for the image
+ */
+bool applyChanges(const uint8_t* changes, size_t size, uint8_t* image,
+                  size_t imageSize)
+{
+    size_t pos = 0;
+    while (pos < size)
+    {
+        GuardJournalChange change;
+        if (size - pos < sizeof(change))
+        {
+            return false;
+        }
+        memcpy(&change, changes + pos, sizeof(change));
+        pos += sizeof(change);
+
+        size_t offset = be32toh(change.offset);
+        size_t length = be16toh(change.length);
+        if ((length > size - pos) || (offset > imageSize) ||
+            (length > imageSize - offset))
+        {
+            return false;
+        }
+        if (image != nullptr)
+        {
+            memcpy(image + offset, changes + pos, length);
+        }
+        pos += length;
+    }
+    return true;
+}
+} // namespace
+
+JournaledGuard::JournaledGuard(const fs::path& journalFile,
+                               size_t maxJournalSize,
+                               std::chrono::milliseconds interval) :
+    file(getGuardFilePath(), getGuardLayout()), maxJournalSize(maxJournalSize),
+    interval(interval)
+{
+    base.resize(file.size());
+    file.read(0, base.data(), base.size());
+    image = base;
+
+    journalFd = open(journalFile.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (journalFd < 0)
+    {
+        GUARD_LOG(GUARD_ERROR, "Failed to open the guard journal %s",
+                  journalFile.c_str());
+        throw GuardFileOpenFailed("Failed to open the guard journal");
+    }
+
+    try
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        replay();
+    }
+    catch (...)
+    {
+        close(journalFd);
+        throw;
+    }
+
+    if (interval.count() > 0)
+    {
+        checkpointer = std::thread(&JournaledGuard::run, this);
+    }
+}
+
+JournaledGuard::~JournaledGuard()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    changed.notify_all();
+    if (checkpointer.joinable())
+    {
+        checkpointer.join();
+    }
+
+    try
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        checkpointLocked();
+    }
+    catch (const std::exception& ex)
+    {
+        GUARD_LOG(GUARD_ERROR,
+                  "Failed to checkpoint the guard journal, exception: %s",
+                  ex.what());
+    }
+    close(journalFd);
+}
+
+GuardRecord JournaledGuard::create(const EntityPath& entityPath, uint32_t eId,
+                                   uint8_t eType, bool overwriteRecord)
+{
+    std::error_code ec;
+    GuardRecord guard;
+    apply([&] {
+        guard = impl::createRecord(file, entityPath, eId, eType,
+                                   overwriteRecord, ec);
+    });
+    if (ec)
+    {
+        throwGuardError(ec);
+    }
+    return guard;
+}
+
+GuardRecords JournaledGuard::getAll(bool persistentTypeOnly)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ImageScope scope(file, image.data());
+    return impl::getAllRecords(file, persistentTypeOnly);
+}
+
+void JournaledGuard::clear(const EntityPath& entityPath, bool forceClear)
+{
+    std::error_code ec;
+    apply([&] { ec = impl::invalidateRecord(file, entityPath, forceClear); });
+    if (ec)
+    {
+        throwGuardError(ec);
+    }
+}
+
+void JournaledGuard::clear(uint32_t recordId, bool forceClear)
+{
+    std::error_code ec;
+    apply([&] { ec = impl::invalidateRecord(file, recordId, forceClear); });
+    if (ec)
+    {
+        throwGuardError(ec);
+    }
+}
+
+void JournaledGuard::invalidateAll()
+{
+    apply([&] { impl::invalidateAll(file); });
+}
+
+void JournaledGuard::checkpoint()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    checkpointLocked();
+}
+
+size_t JournaledGuard::pending()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries;
+}
+
+template <typename Operation>
+void JournaledGuard::apply(Operation&& operation)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    work = image;
+    {
+        ImageScope scope(file, work.data());
+        operation();
+    }
+
+    // One entry with the changed bytes, the unchanged bytes shorter than
+    // a change header are included in the change
+    std::vector<uint8_t> entry(sizeof(GuardJournalEntry));
+    forEachChange(
+        image.data(), work.data(), work.size(), sizeof(GuardJournalChange),
+        [&](size_t start, size_t end) {
+            while (start < end)
+            {
+                size_t length = std::min<size_t>(end - start, UINT16_MAX);
+                GuardJournalChange change;
+                change.offset = htobe32(start);
+                change.length = htobe16(length);
+                const auto* bytes = reinterpret_cast<const uint8_t*>(&change);
+                entry.insert(entry.end(), bytes, bytes + sizeof(change));
+                entry.insert(entry.end(), work.data() + start,
+                             work.data() + start + length);
+                start += length;
+            }
+        });
+    if (entry.size() == sizeof(GuardJournalEntry))
+    {
+        return;
+    }
+
+    GuardJournalEntry header;
+    size_t size = entry.size() - sizeof(header);
+    header.size = htobe32(size);
+    header.crc = htobe32(crc32c(entry.data() + sizeof(header), size));
+    memcpy(entry.data(), &header, sizeof(header));
+
+    // The image is changed only after the entry is in the journal
+    append(entry);
+    image.swap(work);
+    entries++;
+
+    if (journalSize >= maxJournalSize)
+    {
+        checkpointLocked();
+    }
+    else if (entries == 1)
+    {
+        changed.notify_all();
+    }
+}
+
+void JournaledGuard::append(const std::vector<uint8_t>& entry)
+{
+    if (!writeAll(journalFd, entry.data(), entry.size(), journalSize) ||
+        (fdatasync(journalFd) != 0))
+    {
+        GUARD_LOG(GUARD_ERROR, "Failed to write the guard journal, errno: %d",
+                  errno);
+        // Drop the incompletely written entry
+        if (ftruncate(journalFd, journalSize) != 0)
+        {
+            GUARD_LOG(GUARD_ERROR, "Failed to truncate the guard journal");
+        }
+        throw GuardFileWriteFailed("Failed to write the guard journal");
+    }
+    stats::add(stats::counters.fsyncs);
+    journalSize += entry.size();
+}
+
+void JournaledGuard::replay()
+{
+    off_t size = lseek(journalFd, 0, SEEK_END);
+    if (size < 0)
+    {
+        GUARD_LOG(GUARD_ERROR, "Failed to move to the end of guard journal");
+        throw GuardFileSeekFailed("Failed to seek the guard journal");
+    }
+    std::vector<uint8_t> journal(size);
+    size_t done = 0;
+    while (done < journal.size())
+    {
+        ssize_t rc = pread(journalFd, journal.data() + done,
+                           journal.size() - done, done);
+        if ((rc < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if (rc <= 0)
+        {
+            GUARD_LOG(GUARD_ERROR, "Failed to read the guard journal");
+            throw GuardFileReadFailed("Failed to read the guard journal");
+        }
+        done += rc;
+    }
+
+    GuardJournalHeader header;
+    if ((journal.size() < sizeof(header)) ||
+        (memcmp(journal.data(), GUARD_JOURNAL_MAGIC, sizeof(header.magic)) !=
+         0))
+    {
+        resetJournal(GUARD_JOURNAL_IDLE);
+        return;
+    }
+    memcpy(&header, journal.data(), sizeof(header));
+    if (header.version != GUARD_JOURNAL_VERSION)
+    {
+        GUARD_LOG(GUARD_ERROR, "Guard journal version %d is not supported",
+                  header.version);
+        resetJournal(GUARD_JOURNAL_IDLE);
+        return;
+    }
+    // The guard file has only some of the entries if the checkpoint was
+    // interrupted, applying all of them again gives the same content
+    bool staleJournal =
+        (header.state != GUARD_JOURNAL_CHECKPOINTING) &&
+        (be32toh(header.guardCrc) != crc32c(base.data(), base.size()));
+
+    size_t pos = sizeof(header);
+    while (journal.size() - pos >= sizeof(GuardJournalEntry))
+    {
+        GuardJournalEntry entry;
+        memcpy(&entry, journal.data() + pos, sizeof(entry));
+        size_t entrySize = be32toh(entry.size);
+        const uint8_t* changes = journal.data() + pos + sizeof(entry);
+        if ((entrySize > journal.size() - pos - sizeof(entry)) ||
+            (crc32c(changes, entrySize) != be32toh(entry.crc)) ||
+            !applyChanges(changes, entrySize, nullptr, image.size()))
+        {
+            break;
+        }
+        applyChanges(changes, entrySize, image.data(), image.size());
+        pos += sizeof(entry) + entrySize;
+        entries++;
+    }
+
+    // The entries are the changed bytes of the guard file the journal is
+    // started with so, they can not be applied to another content
+    if (staleJournal)
+    {
+        GUARD_LOG(GUARD_ERROR,
+                  "Guard file is changed after the journal is started, "
+                  "discarding %zu guard journal entries",
+                  entries);
+        stats::add(stats::counters.journalDrops, entries);
+        image = base;
+        resetJournal(GUARD_JOURNAL_IDLE);
+        return;
+    }
+
+    journalSize = pos;
+    if (pos < journal.size())
+    {
+        GUARD_LOG(GUARD_INFO, "Dropping %zu bytes of incomplete guard journal",
+                  journal.size() - pos);
+        if (ftruncate(journalFd, pos) != 0)
+        {
+            GUARD_LOG(GUARD_ERROR, "Failed to truncate the guard journal");
+            throw GuardFileWriteFailed("Failed to truncate the guard journal");
+        }
+    }
+    GUARD_LOG(GUARD_DEBUG, "Replayed %zu guard journal entries", entries);
+
+    if (header.state == GUARD_JOURNAL_CHECKPOINTING)
+    {
+        checkpointLocked();
+    }
+}
+
+void JournaledGuard::resetJournal(uint8_t state)
+{
+    GuardJournalHeader header;
+    memcpy(header.magic, GUARD_JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = GUARD_JOURNAL_VERSION;
+    header.state = state;
+    memset(header.pad, 0xff, sizeof(header.pad));
+    header.guardCrc = htobe32(crc32c(base.data(), base.size()));
+
+    bool done = writeAll(journalFd, &header, sizeof(header), 0);
+    if (done && (state == GUARD_JOURNAL_IDLE))
+    {
+        done = (ftruncate(journalFd, sizeof(header)) == 0);
+        journalSize = sizeof(header);
+        entries = 0;
+    }
+    if (!done || (fdatasync(journalFd) != 0))
+    {
+        GUARD_LOG(GUARD_ERROR, "Failed to write the guard journal, errno: %d",
+                  errno);
+        throw GuardFileWriteFailed("Failed to write the guard journal");
+    }
+    stats::add(stats::counters.fsyncs);
+}
+
+void JournaledGuard::checkpointLocked()
+{
+    if (entries == 0)
+    {
+        return;
+    }
+
+    // The state is kept in the journal until the guard file is synced, so
+    // an interrupted checkpoint is completed on the next open
+    resetJournal(GUARD_JOURNAL_CHECKPOINTING);
+    forEachChange(base.data(), image.data(), image.size(),
+                  sizeof(GuardRecord), [&](size_t start, size_t end) {
+                      file.write(start, image.data() + start, end - start);
+                  });
+    file.sync();
+    base = image;
+    resetJournal(GUARD_JOURNAL_IDLE);
+    GUARD_LOG(GUARD_DEBUG, "Checkpointed the guard journal");
+}
+
+void JournaledGuard::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stop)
+    {
+        if (entries == 0)
+        {
+            changed.wait(lock, [this] { return stop || (entries > 0); });
+            continue;
+        }
+
+        // Checkpoint the interval after the first entry, unless it is
+        // done already
+        if (changed.wait_for(lock, interval,
+                             [this] { return stop || (entries == 0); }))
+        {
+            continue;
+        }
+        try
+        {
+            checkpointLocked();
+        }
+        catch (const std::exception& ex)
+        {
+            GUARD_LOG(GUARD_ERROR,
+                      "Failed to checkpoint the guard journal, exception: %s",
+                      ex.what());
+        }
+    }
+}
+} // namespace guard
+} // namespace openpower
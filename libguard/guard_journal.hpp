@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "guard_entity.hpp"
+#include "guard_file.hpp"
+#include "include/guard_record.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openpower
+{
+namespace guard
+{
+namespace fs = std::filesystem;
+
+/**
+ * Journal file header, the values are in big endian. The journal entries
+ * follow the header.
+ */
+struct GuardJournalHeader
+{
+    uint8_t magic[8];  ///< GUARD_JOURNAL_MAGIC
+    uint8_t version;   ///< GUARD_JOURNAL_VERSION
+    uint8_t state;     ///< GuardJournalState
+    uint8_t pad[2];    ///< Padding
+    uint32_t guardCrc; ///< CRC32C of the guard file the journal applies to
+} __attribute__((__packed__));
+
+/**
+ * Journal entry header, followed by the changed parts of the guard file
+ * of one operation, each of them is a GuardJournalChange followed by the
+ * changed bytes. The values are in big endian.
+ */
+struct GuardJournalEntry
+{
+    uint32_t size; ///< Size of the changed parts after the entry header
+    uint32_t crc;  ///< CRC32C of the changed parts
+} __attribute__((__packed__));
+
+struct GuardJournalChange
+{
+    uint32_t offset; ///< Offset of the changed bytes in the guard file
+    uint16_t length; ///< Number of the changed bytes
+} __attribute__((__packed__));
+
+#define GUARD_JOURNAL_MAGIC "GUARDJNL"
+const uint8_t GUARD_JOURNAL_VERSION = 0x1;
+
+/**
+ * Idle          - The guard file is not changed after the journal is
+ *                 started.
+ * Checkpointing - The journal entries are being written to the guard
+ *                 file, which may have only some of them.
+ */
+enum GuardJournalState : uint8_t
+{
+    GUARD_JOURNAL_IDLE = 0x0,
+    GUARD_JOURNAL_CHECKPOINTING = 0x1,
+};
+
+/**
+ * @class JournaledGuard
+ *
+ * Journaled front-end of the guard record operations of the guard file in
+ * use, for the applications which change the guard records in bursts.
+ * The operations are applied on an image of the guard file and, only the
+ * changed bytes are appended to the journal file as one entry per
+ * operation. The journal entries are written to the guard file together
+ * by checkpoint(), which is done when the journal is full, periodically
+ * if the interval is given and, on destruction.
+ *
+ * The guard file always has the guard records of the last checkpoint in
+ * the Hostboot layout so, the checkpoint must be done before the host is
+ * powered on. The guard file must not be changed by the other writers
+ * while it is opened here, the changes by them before the checkpoint are
+ * lost. The readers of the guard file see the records of the last
+ * checkpoint, getAll() here returns the records with the journal entries.
+ *
+ * On construction, the journal entries which are not written to the
+ * guard file yet are applied to the image, up to the first entry which
+ * is not completely written. The journal is discarded if the guard file
+ * is changed after the journal is started, e.g. by Hostboot, and the
+ * discarded entries are counted in GuardStats::journalDrops.
+ *
+ * The errors are reported with the exceptions of the synchronous APIs.
+ */
+class JournaledGuard
+{
+  public:
+    JournaledGuard(const JournaledGuard&) = delete;
+    JournaledGuard& operator=(const JournaledGuard&) = delete;
+    JournaledGuard(JournaledGuard&&) = delete;
+    JournaledGuard& operator=(JournaledGuard&&) = delete;
+
+    /**
+     * @brief Constructor, opens the journal of the guard file in use i.e.
+     *        libguard_init() must be called already and, applies the
+     *        journal entries which are not written to the guard file yet
+     *
+     * @param[in] journalFile journal file, created if it does not exist
+     * @param[in] maxJournalSize journal size to checkpoint at
+     * @param[in] interval time to checkpoint after the first journal
+     *                     entry, 0 to checkpoint only when the journal is
+     *                     full or on request
+     */
+    JournaledGuard(const fs::path& journalFile, size_t maxJournalSize = 4096,
+                   std::chrono::milliseconds interval =
+                       std::chrono::milliseconds(0));
+
+    /**
+     * @brief Destructor, writes the journal entries to the guard file
+     */
+    ~JournaledGuard();
+
+    /**
+     * @brief Create the guard record, see create()
+     */
+    GuardRecord create(const EntityPath& entityPath, uint32_t eId = 0,
+                       uint8_t eType = GARD_User_Manual,
+                       bool overwriteRecord = true);
+
+    /**
+     * @brief Get the guard records with the journal entries, see getAll()
+     */
+    GuardRecords getAll(bool persistentTypeOnly = false);
+
+    /**
+     * @brief Resolve the guard record of the target, see clear()
+     */
+    void clear(const EntityPath& entityPath, bool forceClear = false);
+
+    /**
+     * @brief Resolve the guard record of the record id, see clear()
+     */
+    void clear(uint32_t recordId, bool forceClear = false);
+
+    /**
+     * @brief Resolve all the guard records except the core records, see
+     *        invalidateAll()
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Write the journal entries to the guard file and, empty the
+     *        journal
+     *
+     * @return NULL, throws the guard file exceptions on the failures
+     */
+    void checkpoint();
+
+    /**
+     * @brief Return the number of journal entries which are not written
+     *        to the guard file
+     */
+    size_t pending();
+
+  private:
+    template <typename Operation>
+    void apply(Operation&& operation);
+    void append(const std::vector<uint8_t>& entry);
+    void replay();
+    void resetJournal(uint8_t state);
+    void checkpointLocked();
+    void run();
+
+    GuardFile file;
+    int journalFd = -1;
+    size_t maxJournalSize;
+    std::chrono::milliseconds interval;
+
+    std::vector<uint8_t> base;  ///< Content of the guard file
+    std::vector<uint8_t> image; ///< Content with the journal entries
+    std::vector<uint8_t> work;  ///< Content changed by the operation
+    uint64_t journalSize = 0;
+    size_t entries = 0;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool stop = false;
+    std::thread checkpointer;
+};
+} // namespace guard
+} // namespace openpower
@@ -3,7 +3,9 @@
 
 #include "guard_log.hpp"
 
-#include <iostream>
+#include "guard_log_sink.hpp"
+
+#include <memory>
 
 namespace openpower
 {
@@ -11,6 +13,31 @@ namespace guard
 {
 namespace log
 {
+/**
+ * @brief Helper function to return the sink in use
+ *
+ * The sink is destroyed at the process exit, that writes out the traces
+ * which are buffered by the sink.
+ */
+static std::shared_ptr<LogSink>& logSink()
+{
+    static std::shared_ptr<LogSink> sink = std::make_shared<StdoutLogSink>();
+    return sink;
+}
+
+void setLogSink(std::shared_ptr<LogSink> sink)
+{
+    if (!sink)
+    {
+        sink = std::make_shared<StdoutLogSink>();
+    }
+    std::atomic_store(&logSink(), std::move(sink));
+}
+
+std::shared_ptr<LogSink> getLogSink()
+{
+    return std::atomic_load(&logSink());
+}
 
 void guard_log(int loglevel, const char* fmt, ...)
 {
@@ -19,12 +46,10 @@ void guard_log(int loglevel, const char* fmt, ...)
         return;
     }
 
+    auto sink = getLogSink();
     va_list ap;
     va_start(ap, fmt);
-
-    vprintf(fmt, ap);
-    std::cout << "\n";
-
+    sink->write(loglevel, fmt, ap);
     va_end(ap);
 }
 
@@ -11,6 +11,33 @@
 #define GUARD_INFO 6
 #define GUARD_DEBUG 7
 
+/**
+ * Build time log level, the traces above this level are compiled out by
+ * GUARD_LOG(). libguard is built with the configured verbose level and,
+ * all the traces are kept by default for the other users.
+ */
+#ifndef GUARD_LOG_LEVEL
+#define GUARD_LOG_LEVEL GUARD_DEBUG
+#endif
+
+/**
+ * @brief Log the traces which are enabled in the build time log level
+ *
+ * The trace arguments are not evaluated and, the call is removed by
+ * the compiler if the given level is above GUARD_LOG_LEVEL.
+ *
+ * @param[in] level type of log i.e. GUARD_DEBUG, GUARD_ERROR, GUARD_INFO
+ * @param[in] ... trace string and its arguments, same as guard_log()
+ */
+#define GUARD_LOG(level, ...)                                                  \
+    do                                                                         \
+    {                                                                          \
+        if constexpr ((level) <= GUARD_LOG_LEVEL)                              \
+        {                                                                      \
+            openpower::guard::log::guard_log((level), __VA_ARGS__);            \
+        }                                                                      \
+    } while (0)
+
 namespace openpower
 {
 namespace guard
@@ -23,6 +50,9 @@ namespace log
  * @param[in] fmt trace string
  * @param[in] ... variable set of arguments can be passed like %d,%s etc
  * @return NULL
+ *
+ * @note Use GUARD_LOG() to compile out the traces which are above the
+ *       build time log level.
  **/
 void guard_log(int loglevel, const char* fmt, ...);
 
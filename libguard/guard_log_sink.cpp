@@ -0,0 +1,513 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_log_sink.hpp"
+
+#include "guard_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace openpower
+{
+namespace guard
+{
+namespace log
+{
+/**
+ * Type of the binary trace arguments, as per the length modifier and
+ * the conversion of the trace string.
+ */
+enum ArgType : uint8_t
+{
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_INTMAX,
+    ARG_SIZE,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_POINTER,
+    ARG_STRING
+};
+
+/**
+ * @brief Conversion specification of the trace string
+ */
+struct ConversionSpec
+{
+    size_t len;      ///< Length of the specification including '%'
+    bool hasArg;     ///< false for "%%"
+    bool supported;  ///< false if the arguments can not be queued as binary
+    ArgType argType; ///< Type of the argument
+};
+
+/**
+ * @brief Parse the conversion specification at the given '%'
+ *
+ * @param[in] spec the conversion specification
+ *
+ * @return parsed conversion specification
+ */
+static ConversionSpec parseConversionSpec(const char* spec)
+{
+    ConversionSpec conv{1, true, true, ARG_INT};
+    const char* p = spec + 1;
+    if (*p == '%')
+    {
+        conv.len = 2;
+        conv.hasArg = false;
+        return conv;
+    }
+
+    // Flags, width and precision, '*' needs one more argument
+    while ((*p != '\0') && (strchr("-+ #0123456789.'", *p) != nullptr))
+    {
+        p++;
+    }
+    if (*p == '*')
+    {
+        conv.supported = false;
+    }
+
+    // Length modifiers
+    enum
+    {
+        NONE,
+        LONG,
+        LLONG,
+        INTMAX,
+        SIZE,
+        PTRDIFF,
+        LDOUBLE
+    } length = NONE;
+    while ((*p != '\0') && (strchr("hlLjzt", *p) != nullptr))
+    {
+        switch (*p)
+        {
+            case 'l':
+                length = (length == LONG) ? LLONG : LONG;
+                break;
+            case 'L':
+                length = LDOUBLE;
+                break;
+            case 'j':
+                length = INTMAX;
+                break;
+            case 'z':
+                length = SIZE;
+                break;
+            case 't':
+                length = PTRDIFF;
+                break;
+            default:
+                // 'h' and "hh" arguments are promoted to int
+                break;
+        }
+        p++;
+    }
+
+    switch (*p)
+    {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            conv.argType = (length == LONG)      ? ARG_LONG
+                           : (length == LLONG)   ? ARG_LLONG
+                           : (length == INTMAX)  ? ARG_INTMAX
+                           : (length == SIZE)    ? ARG_SIZE
+                           : (length == PTRDIFF) ? ARG_PTRDIFF
+                                                 : ARG_INT;
+            conv.supported = conv.supported && (length != LDOUBLE);
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            conv.argType = ARG_DOUBLE;
+            conv.supported = conv.supported && (length == NONE);
+            break;
+        case 'p':
+            conv.argType = ARG_POINTER;
+            break;
+        case 's':
+            conv.argType = ARG_STRING;
+            conv.supported = conv.supported && (length == NONE);
+            break;
+        default:
+            // "%n", wide characters and invalid specifications
+            conv.supported = false;
+            break;
+    }
+    if (*p != '\0')
+    {
+        p++;
+    }
+    conv.len = p - spec;
+    return conv;
+}
+
+/**
+ * @brief Helper function to write the formatted trace to the sink
+ */
+static void writeText(LogSink& sink, int level, const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    sink.write(level, fmt, ap);
+    va_end(ap);
+}
+
+void StdoutLogSink::write(int /*level*/, const char* fmt, va_list ap)
+{
+    char buf[256];
+    va_list apCopy;
+    va_copy(apCopy, ap);
+    int len = vsnprintf(buf, sizeof(buf) - 1, fmt, apCopy);
+    va_end(apCopy);
+    if (len < 0)
+    {
+        return;
+    }
+
+    // The line is written by one buffered stdio call so, the traces are
+    // not interleaved with each other and with std::cout, which is
+    // synchronized with stdio.
+    if (static_cast<size_t>(len) < sizeof(buf) - 1)
+    {
+        buf[len] = '\n';
+        fwrite(buf, 1, len + 1, stdout);
+        return;
+    }
+
+    // Long trace, format again into the buffer of the required size
+    std::vector<char> longBuf(len + 2);
+    vsnprintf(longBuf.data(), len + 1, fmt, ap);
+    longBuf[len] = '\n';
+    fwrite(longBuf.data(), 1, len + 1, stdout);
+}
+
+void StdoutLogSink::flush()
+{
+    fflush(stdout);
+}
+
+AsyncLogSink::AsyncLogSink(std::shared_ptr<LogSink> target, size_t capacity,
+                           Format format) :
+    target(std::move(target)),
+    format(format)
+{
+    size_t slotCount = 2;
+    while (slotCount < capacity)
+    {
+        slotCount <<= 1;
+    }
+    slots = std::make_unique<Slot[]>(slotCount);
+    for (size_t i = 0; i < slotCount; i++)
+    {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask = slotCount - 1;
+    flusher = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wakeup.notify_one();
+    flusher.join();
+    target->flush();
+}
+
+bool AsyncLogSink::encodeBinary(Record& record, const char* fmt, va_list ap)
+{
+    record.fmt = fmt;
+    record.argCount = 0;
+    record.dataLen = 0;
+    for (const char* p = strchr(fmt, '%'); p != nullptr; p = strchr(p, '%'))
+    {
+        auto conv = parseConversionSpec(p);
+        p += conv.len;
+        if (!conv.hasArg)
+        {
+            continue;
+        }
+        if (!conv.supported || (record.argCount == maxArgs))
+        {
+            return false;
+        }
+
+        uint64_t& arg = record.args[record.argCount];
+        switch (conv.argType)
+        {
+            case ARG_INT:
+                arg = static_cast<uint64_t>(va_arg(ap, int));
+                break;
+            case ARG_LONG:
+                arg = static_cast<uint64_t>(va_arg(ap, long));
+                break;
+            case ARG_LLONG:
+                arg = static_cast<uint64_t>(va_arg(ap, long long));
+                break;
+            case ARG_INTMAX:
+                arg = static_cast<uint64_t>(va_arg(ap, intmax_t));
+                break;
+            case ARG_SIZE:
+                arg = static_cast<uint64_t>(va_arg(ap, size_t));
+                break;
+            case ARG_PTRDIFF:
+                arg = static_cast<uint64_t>(va_arg(ap, ptrdiff_t));
+                break;
+            case ARG_DOUBLE:
+            {
+                double value = va_arg(ap, double);
+                memcpy(&arg, &value, sizeof(value));
+                break;
+            }
+            case ARG_POINTER:
+                arg = reinterpret_cast<uintptr_t>(va_arg(ap, void*));
+                break;
+            case ARG_STRING:
+            {
+                // The string is copied, the argument is the offset in data
+                const char* value = va_arg(ap, const char*);
+                if (value == nullptr)
+                {
+                    value = "(null)";
+                }
+                size_t len = strlen(value) + 1;
+                if (len > dataSize - record.dataLen)
+                {
+                    return false;
+                }
+                memcpy(record.data + record.dataLen, value, len);
+                arg = record.dataLen;
+                record.dataLen += len;
+                break;
+            }
+        }
+        record.argTypes[record.argCount++] = conv.argType;
+    }
+    return true;
+}
+
+void AsyncLogSink::write(int level, const char* fmt, va_list ap)
+{
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true)
+    {
+        slot = &slots[pos & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff =
+            static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                 std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Ring buffer is full
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record& record = slot->record;
+    record.level = static_cast<uint8_t>(level);
+    va_list apCopy;
+    va_copy(apCopy, ap);
+    bool binary =
+        (format == Format::Binary) && encodeBinary(record, fmt, apCopy);
+    va_end(apCopy);
+    if (!binary)
+    {
+        // Text record, truncated to the record size
+        record.fmt = nullptr;
+        int len = vsnprintf(record.data, sizeof(record.data), fmt, ap);
+        record.dataLen = (len < 0) ? 0
+                                   : std::min(static_cast<size_t>(len),
+                                              sizeof(record.data) - 1);
+    }
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    wakeup.notify_one();
+}
+
+void AsyncLogSink::formatBinary(const Record& record, std::string& line)
+{
+    char spec[32];
+    char buf[256];
+    size_t argIndex = 0;
+    const char* p = record.fmt;
+    line.clear();
+    while (*p != '\0')
+    {
+        const char* next = strchr(p, '%');
+        if (next == nullptr)
+        {
+            line.append(p);
+            break;
+        }
+        line.append(p, next - p);
+        auto conv = parseConversionSpec(next);
+        p = next + conv.len;
+        if (!conv.hasArg)
+        {
+            line.push_back('%');
+            continue;
+        }
+
+        size_t specLen = std::min(conv.len, sizeof(spec) - 1);
+        memcpy(spec, next, specLen);
+        spec[specLen] = '\0';
+        uint64_t arg = record.args[argIndex];
+        int len = 0;
+        switch (record.argTypes[argIndex++])
+        {
+            case ARG_INT:
+                len = snprintf(buf, sizeof(buf), spec, static_cast<int>(arg));
+                break;
+            case ARG_LONG:
+                len = snprintf(buf, sizeof(buf), spec, static_cast<long>(arg));
+                break;
+            case ARG_LLONG:
+                len = snprintf(buf, sizeof(buf), spec,
+                               static_cast<long long>(arg));
+                break;
+            case ARG_INTMAX:
+                len = snprintf(buf, sizeof(buf), spec,
+                               static_cast<intmax_t>(arg));
+                break;
+            case ARG_SIZE:
+                len = snprintf(buf, sizeof(buf), spec,
+                               static_cast<size_t>(arg));
+                break;
+            case ARG_PTRDIFF:
+                len = snprintf(buf, sizeof(buf), spec,
+                               static_cast<ptrdiff_t>(arg));
+                break;
+            case ARG_DOUBLE:
+            {
+                double value;
+                memcpy(&value, &arg, sizeof(value));
+                len = snprintf(buf, sizeof(buf), spec, value);
+                break;
+            }
+            case ARG_POINTER:
+                len = snprintf(buf, sizeof(buf), spec,
+                               reinterpret_cast<void*>(arg));
+                break;
+            case ARG_STRING:
+                len = snprintf(buf, sizeof(buf), spec, record.data + arg);
+                break;
+        }
+        if (len > 0)
+        {
+            line.append(buf, std::min(static_cast<size_t>(len),
+                                      sizeof(buf) - 1));
+        }
+    }
+}
+
+bool AsyncLogSink::consume()
+{
+    std::string line;
+    bool written = false;
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = slots[pos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            break;
+        }
+
+        const Record& record = slot.record;
+        if (record.fmt != nullptr)
+        {
+            formatBinary(record, line);
+        }
+        else
+        {
+            line.assign(record.data, record.dataLen);
+        }
+        int level = record.level;
+        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+        pos++;
+        written = true;
+
+        writeText(*target, level, "%s", line.c_str());
+    }
+
+    uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped != reportedDropped)
+    {
+        writeText(*target, GUARD_WARNING,
+                  "%llu traces are dropped since the log buffer is full",
+                  static_cast<unsigned long long>(dropped - reportedDropped));
+        reportedDropped = dropped;
+    }
+
+    // Traces are written out till this position, used by flush()
+    dequeuePos.store(pos, std::memory_order_release);
+    return written;
+}
+
+void AsyncLogSink::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stop)
+    {
+        // The producers do not take the lock to notify so, the wakeup
+        // can be missed and the timeout bounds the delay.
+        wakeup.wait_for(lock, std::chrono::milliseconds(100));
+        lock.unlock();
+        consume();
+        lock.lock();
+        consumed.notify_all();
+    }
+    lock.unlock();
+    consume();
+}
+
+void AsyncLogSink::flush()
+{
+    size_t pos = enqueuePos.load(std::memory_order_acquire);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop && (dequeuePos.load(std::memory_order_acquire) < pos))
+        {
+            wakeup.notify_one();
+            consumed.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+    target->flush();
+}
+
+uint64_t AsyncLogSink::dropped() const
+{
+    return droppedCount.load(std::memory_order_relaxed);
+}
+} // namespace log
+} // namespace guard
+} // namespace openpower
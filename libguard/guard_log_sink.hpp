@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <stdarg.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace openpower
+{
+namespace guard
+{
+namespace log
+{
+/**
+ * @class LogSink
+ *
+ * Destination of the traces which are enabled by the log level. The
+ * trace is passed unformatted so, the sink can decide when to format.
+ */
+class LogSink
+{
+  public:
+    virtual ~LogSink() = default;
+
+    /**
+     * @brief Write the trace
+     *
+     * @param[in] level log level of the trace
+     * @param[in] fmt trace string
+     * @param[in] ap arguments of the trace string
+     *
+     * @return NULL
+     */
+    virtual void write(int level, const char* fmt, va_list ap) = 0;
+
+    /**
+     * @brief Write out the traces which are buffered by the sink
+     *
+     * @return NULL
+     */
+    virtual void flush()
+    {
+    }
+};
+
+/**
+ * @class StdoutLogSink
+ *
+ * Default sink, the traces are formatted by the caller and written to
+ * stdout line by line.
+ */
+class StdoutLogSink : public LogSink
+{
+  public:
+    void write(int level, const char* fmt, va_list ap) override;
+    void flush() override;
+};
+
+/**
+ * @class AsyncLogSink
+ *
+ * The traces are queued into a lock-free ring buffer and, a background
+ * thread writes them to the target sink so, the caller is not blocked
+ * by a slow console. The traces are dropped if the ring buffer is full,
+ * the number of dropped traces is written to the target sink when there
+ * is space again.
+ */
+class AsyncLogSink : public LogSink
+{
+  public:
+    /**
+     * @brief Format of the queued traces
+     *
+     * Text   - The trace is formatted by the caller.
+     * Binary - The trace string pointer and the arguments are queued and,
+     *          the trace is formatted by the background thread. The trace
+     *          string must not be freed or changed after logging, as it
+     *          is for the string literals. The string arguments are copied.
+     *          The traces which can not be queued as binary e.g. having
+     *          too many arguments are queued as text.
+     */
+    enum class Format
+    {
+        Text,
+        Binary
+    };
+
+    AsyncLogSink() = delete;
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+    AsyncLogSink(AsyncLogSink&&) = delete;
+    AsyncLogSink& operator=(AsyncLogSink&&) = delete;
+
+    /**
+     * @brief Constructor, starts the background thread
+     *
+     * @param[in] target sink to write the traces from the background thread
+     * @param[in] capacity number of traces in the ring buffer, rounded up
+     *                     to the power of two
+     * @param[in] format format of the queued traces
+     */
+    AsyncLogSink(std::shared_ptr<LogSink> target, size_t capacity = 1024,
+                 Format format = Format::Text);
+
+    /**
+     * @brief Destructor, writes the queued traces and stops the background
+     *        thread
+     */
+    ~AsyncLogSink() override;
+
+    /**
+     * @brief Queue the trace, never blocks
+     */
+    void write(int level, const char* fmt, va_list ap) override;
+
+    /**
+     * @brief Wait until the traces queued before are written to the target
+     *        sink and flush the target sink
+     */
+    void flush() override;
+
+    /**
+     * @brief Return the number of traces dropped since the ring buffer
+     *        was full
+     */
+    uint64_t dropped() const;
+
+  private:
+    static constexpr size_t maxArgs = 8;
+    static constexpr size_t dataSize = 192;
+
+    /**
+     * @brief Queued trace
+     *
+     * The data is the formatted trace for the text records and the copy
+     * of the string arguments for the binary records.
+     */
+    struct Record
+    {
+        const char* fmt; ///< Trace string, nullptr for the text records
+        uint64_t args[maxArgs];
+        uint8_t argTypes[maxArgs];
+        uint8_t argCount;
+        uint8_t level;
+        uint16_t dataLen;
+        char data[dataSize];
+    };
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    bool encodeBinary(Record& record, const char* fmt, va_list ap);
+    void formatBinary(const Record& record, std::string& line);
+    bool consume();
+    void run();
+
+    std::shared_ptr<LogSink> target;
+    Format format;
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0}; ///< Written out position
+    std::atomic<uint64_t> droppedCount{0};
+    uint64_t reportedDropped = 0;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable consumed;
+    bool stop = false;
+    std::thread flusher;
+};
+
+/**
+ * @brief Set the sink of the traces for the process
+ *
+ * @param[in] sink sink to use, nullptr to use the default stdout sink
+ *
+ * @return NULL
+ */
+void setLogSink(std::shared_ptr<LogSink> sink);
+
+/**
+ * @brief Get the sink of the traces
+ *
+ * @return sink in use
+ */
+std::shared_ptr<LogSink> getLogSink();
+} // namespace log
+} // namespace guard
+} // namespace openpower
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_migrate.hpp"
+
+#include "guard_codec.hpp"
+#include "guard_error.hpp"
+#include "guard_exception.hpp"
+#include "guard_file.hpp"
+#include "guard_interface_impl.hpp"
+#include "guard_log.hpp"
+#include "guard_stats.hpp"
+
+#include <endian.h>
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+namespace openpower
+{
+namespace guard
+{
+using namespace openpower::guard::log;
+using namespace openpower::guard::exception;
+
+namespace
+{
+// Slots converted at a time, bounds the memory used by the migration
+constexpr size_t chunkSlots = 64;
+
+/**
+ * @brief Copy the guard records from the source layout to the target
+ *        layout, see migrate()
+ *
+ * @param[in] source GUARD file to read, in the From layout
+ * @param[in] target GUARD file to write, in the To layout
+ * @param[in] dropResolved do not copy the resolved records
+ *
+ * @return number of the records written to the target
+ */
+template <typename From, typename To>
+size_t migrateRecords(GuardFile& source, GuardFile& target,
+                      bool dropResolved)
+{
+    uint8_t in[chunkSlots * From::recordSize];
+    uint8_t out[chunkSlots * To::recordSize];
+    size_t sourceSlots = From::slots(source.size());
+    size_t targetSlots = To::slots(target.size());
+    size_t written = 0;
+    uint32_t resolvedSlots = 0;
+    uint32_t maxId = 0;
+
+    bool end = false;
+    for (size_t pos = 0; (pos < sourceSlots) && !end; pos += chunkSlots)
+    {
+        size_t count = std::min(chunkSlots, sourceSlots - pos);
+        source.read(From::offset(pos), in, count * From::recordSize);
+
+        // The bytes of the target slots which are not in GuardRecord are
+        // left erased
+        memset(out, 0xff, sizeof(out));
+        size_t converted = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            GuardRecord record;
+            From::decode(in + i * From::recordSize, record);
+            if (From::isBlank(record))
+            {
+                end = true;
+                break;
+            }
+            stats::add(stats::counters.recordsScanned);
+
+            bool resolved = (record.recordId == GUARD_RESOLVED);
+            if ((resolved && dropResolved) || !isRecordIntact(record))
+            {
+                continue;
+            }
+            if (written + converted >= targetSlots)
+            {
+                GUARD_LOG(GUARD_ERROR,
+                          "Target GUARD file has %zu slots, which are not "
+                          "enough for the guard records",
+                          targetSlots);
+                throwGuardError(GuardError::GuardFileOverFlowed);
+            }
+            if (resolved)
+            {
+                resolvedSlots++;
+            }
+            else
+            {
+                maxId = std::max(maxId, be32toh(record.recordId));
+            }
+            if constexpr (To::isNative)
+            {
+                sealRecord(record);
+            }
+            memcpy(out + converted * To::recordSize, &record, To::copySize);
+            converted++;
+        }
+        if (converted > 0)
+        {
+            target.write(To::offset(written), out,
+                         converted * To::recordSize);
+            written += converted;
+        }
+    }
+
+    uint64_t usedSize = To::offset(written);
+    if (usedSize < target.size())
+    {
+        target.erase(usedSize, target.size() - usedSize);
+    }
+    if constexpr (To::hasHeader)
+    {
+        impl::formatHeader(target, written, resolvedSlots, maxId + 1);
+    }
+    return written;
+}
+} // namespace
+
+size_t migrate(const fs::path& source, const fs::path& target,
+               GuardLayout layout, bool dropResolved)
+{
+    GuardFile sourceFile(source);
+    GuardFile targetFile(target, layout);
+    std::error_code ec;
+    if (fs::equivalent(source, target, ec))
+    {
+        GUARD_LOG(GUARD_ERROR, "Migration target is the source GUARD file");
+        throw InvalidEntry("Migration target is the source GUARD file");
+    }
+    if (targetFile.size() == 0)
+    {
+        throw InvalidGuardFile("Empty migration target GUARD file " +
+                               target.string());
+    }
+    sourceFile.setLayout(impl::detectLayout(sourceFile));
+
+    size_t records = withCodec(sourceFile.layout(), [&](auto from) {
+        return withCodec(layout, [&](auto to) {
+            return migrateRecords<decltype(from), decltype(to)>(
+                sourceFile, targetFile, dropResolved);
+        });
+    });
+    targetFile.sync();
+    GUARD_LOG(GUARD_INFO, "Migrated %zu guard records", records);
+    return records;
+}
+} // namespace guard
+} // namespace openpower
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "include/guard_record.hpp"
+
+#include <cstddef>
+#include <filesystem>
+
+namespace openpower
+{
+namespace guard
+{
+namespace fs = std::filesystem;
+
+/**
+ * @brief Copy the guard records of the GUARD file to the other GUARD file
+ *        in the given layout, e.g. during the code update
+ *
+ * The records are converted in one pass, a fixed number of slots at a time
+ * so, the memory used does not depend on the partition size. The layout of
+ * the source is detected from its content and, the source is not changed.
+ * The target is formatted in the given layout with its size kept, that is
+ * the header of the standard layout is written with the current version
+ * and, the slots after the records are erased. The order and the ids of
+ * the records are kept, the records with the checksum mismatch are not
+ * copied.
+ *
+ * @param[in] source GUARD file to read
+ * @param[in] target GUARD file to write, it must exist and it must not be
+ *                   the source
+ * @param[in] layout layout of the target
+ * @param[in] dropResolved do not copy the resolved records, to fit the
+ *                         records into the smaller target
+ *
+ * @return number of the records written to the target. Throws the guard
+ *         file exceptions on the I/O failures, InvalidEntry if the target
+ *         is the source and, GuardFileOverFlowed if the records do not fit
+ *         into the target.
+ */
+size_t migrate(const fs::path& source, const fs::path& target,
+               GuardLayout layout, bool dropResolved = false);
+} // namespace guard
+} // namespace openpower
@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_scan.hpp"
+
+#include "include/guard_record.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace openpower
+{
+namespace guard
+{
+namespace
+{
+// Offset and size of the target id in the record slots
+constexpr size_t keyPos = offsetof(GuardRecord, targetId);
+constexpr size_t keySize = sizeof(EntityPath);
+
+static_assert(offsetof(GuardRecord, recordId) == 0);
+
+/**
+ * @brief Return the class of the slot which is not blank, without the
+ *        match flag
+ */
+inline uint8_t slotClass(const uint8_t* slot)
+{
+    uint32_t recordId;
+    memcpy(&recordId, slot, sizeof(recordId));
+    return (recordId == GUARD_RESOLVED) ? SLOT_RESOLVED : SLOT_LIVE;
+}
+
+#if defined(__SSE2__) || defined(__ARM_NEON) || defined(__VSX__)
+#define GUARD_SCAN_VECTOR
+#endif
+
+#ifdef GUARD_SCAN_VECTOR
+/**
+ * The generic vector types of the compiler, which are the SSE2, NEON or
+ * VSX registers of the CPU for 16 bytes and, the AVX2 registers in the
+ * functions built for AVX2 for 32 bytes.
+ */
+typedef uint8_t Vec16 __attribute__((vector_size(16)));
+typedef uint8_t Vec32 __attribute__((vector_size(32)));
+
+/**
+ * Key to match the slots with, in windows of the vector size. The mask
+ * selects type_size and the path elements in use, like
+ * EntityPath::operator==.
+ */
+template <typename Vec>
+struct VecKey
+{
+    static constexpr size_t windows = (keySize + sizeof(Vec) - 1) /
+                                      sizeof(Vec);
+
+    size_t offset[windows];
+    Vec value[windows];
+    Vec mask[windows];
+};
+
+template <typename Vec>
+__attribute__((always_inline)) inline Vec load(const uint8_t* data)
+{
+    Vec vec;
+    memcpy(&vec, data, sizeof(vec));
+    return vec;
+}
+
+/**
+ * @brief Return true if all the bits of the vector are 1 (all is true) or,
+ *        0 (all is false)
+ */
+template <typename Vec>
+__attribute__((always_inline)) inline bool all(Vec vec, bool set)
+{
+    uint64_t words[sizeof(Vec) / sizeof(uint64_t)];
+    memcpy(words, &vec, sizeof(words));
+    uint64_t acc = set ? ~0ULL : 0;
+    for (auto word : words)
+    {
+        acc = set ? (acc & word) : (acc | word);
+    }
+    return acc == (set ? ~0ULL : 0);
+}
+
+template <typename Vec>
+void makeVecKey(const EntityPath& key, VecKey<Vec>& vecKey)
+{
+    // Key and mask at their offsets in the slot, with the room for the
+    // window which is wider than the key
+    uint8_t value[keyPos + keySize + sizeof(Vec)] = {};
+    uint8_t mask[sizeof(value)] = {};
+    memcpy(value + keyPos, &key, keySize);
+    memset(mask + keyPos, 0xff,
+           sizeof(key.type_size) +
+               (key.type_size & 0x0F) * sizeof(EntityPath::PathElement));
+
+    for (size_t window = 0; window < vecKey.windows; window++)
+    {
+        // The last window is moved back to end with the key, unless the
+        // key fits into one window
+        size_t offset = keyPos + std::min(window * sizeof(Vec),
+                                          keySize > sizeof(Vec)
+                                              ? keySize - sizeof(Vec)
+                                              : 0);
+        vecKey.offset[window] = offset;
+        vecKey.value[window] = load<Vec>(value + offset);
+        vecKey.mask[window] = load<Vec>(mask + offset);
+    }
+}
+
+/**
+ * @brief scanSlots() with the vectors of the given size, the slots must
+ *        have the vector size for the blank check and, for the key window
+ *        after the key position
+ */
+template <typename Vec>
+__attribute__((always_inline)) inline size_t
+    scanSlotsVec(const uint8_t* slots, size_t count, size_t slotSize,
+                 size_t blankSize, const VecKey<Vec>* key, uint8_t* classes)
+{
+    constexpr size_t width = sizeof(Vec);
+    for (size_t pos = 0; pos < count; pos++)
+    {
+        const uint8_t* slot = slots + pos * slotSize;
+
+        // The last load overlaps the others if the size is not a multiple
+        // of the vector size
+        Vec blank = load<Vec>(slot + blankSize - width);
+        for (size_t i = 0; i + width < blankSize; i += width)
+        {
+            blank &= load<Vec>(slot + i);
+        }
+        if (all(blank, true))
+        {
+            return pos;
+        }
+
+        uint8_t cls = slotClass(slot);
+        if (key != nullptr)
+        {
+            Vec diff = {};
+            for (size_t window = 0; window < key->windows; window++)
+            {
+                diff |= (load<Vec>(slot + key->offset[window]) ^
+                         key->value[window]) &
+                        key->mask[window];
+            }
+            cls |= all(diff, false) ? SLOT_MATCH : 0;
+        }
+        classes[pos] = cls;
+    }
+    return count;
+}
+
+size_t scanSlots16(const uint8_t* slots, size_t count, size_t slotSize,
+                   size_t blankSize, const EntityPath* key, uint8_t* classes)
+{
+    VecKey<Vec16> vecKey;
+    if (key != nullptr)
+    {
+        makeVecKey(*key, vecKey);
+    }
+    return scanSlotsVec<Vec16>(slots, count, slotSize, blankSize,
+                               key != nullptr ? &vecKey : nullptr, classes);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) size_t
+    scanSlotsAvx2(const uint8_t* slots, size_t count, size_t slotSize,
+                  size_t blankSize, const EntityPath* key, uint8_t* classes)
+{
+    VecKey<Vec32> vecKey;
+    if (key != nullptr)
+    {
+        makeVecKey(*key, vecKey);
+    }
+    return scanSlotsVec<Vec32>(slots, count, slotSize, blankSize,
+                               key != nullptr ? &vecKey : nullptr, classes);
+}
+
+bool hasAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+#endif
+} // namespace
+
+size_t scanSlots(const uint8_t* slots, size_t count, size_t slotSize,
+                 size_t blankSize, const EntityPath* key, uint8_t* classes)
+{
+    if ((key != nullptr) && !key->isValid())
+    {
+        key = nullptr;
+    }
+#ifdef GUARD_SCAN_VECTOR
+#if defined(__x86_64__)
+    static const bool avx2 = hasAvx2();
+    if (avx2 && (blankSize >= sizeof(Vec32)) &&
+        (slotSize >= keyPos + sizeof(Vec32)))
+    {
+        return scanSlotsAvx2(slots, count, slotSize, blankSize, key,
+                             classes);
+    }
+#endif
+    if ((blankSize >= sizeof(Vec16)) && (slotSize >= keyPos + keySize))
+    {
+        return scanSlots16(slots, count, slotSize, blankSize, key, classes);
+    }
+#endif
+    return scanSlotsPortable(slots, count, slotSize, blankSize, key, classes);
+}
+
+size_t scanSlotsPortable(const uint8_t* slots, size_t count, size_t slotSize,
+                         size_t blankSize, const EntityPath* key,
+                         uint8_t* classes)
+{
+    for (size_t pos = 0; pos < count; pos++)
+    {
+        const uint8_t* slot = slots + pos * slotSize;
+        if (std::all_of(slot, slot + blankSize,
+                        [](uint8_t byte) { return byte == 0xff; }))
+        {
+            return pos;
+        }
+
+        uint8_t cls = slotClass(slot);
+        if (key != nullptr)
+        {
+            EntityPath targetId;
+            memcpy(&targetId, slot + keyPos, keySize);
+            cls |= (targetId == *key) ? SLOT_MATCH : 0;
+        }
+        classes[pos] = cls;
+    }
+    return count;
+}
+} // namespace guard
+} // namespace openpower
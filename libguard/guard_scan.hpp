@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "guard_common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace openpower
+{
+namespace guard
+{
+/**
+ * Classes of the record slots before the first blank slot, the match flag
+ * is set along with one of the others
+ */
+enum SlotClass : uint8_t
+{
+    SLOT_LIVE = 0x0,     ///< Guard record in use
+    SLOT_RESOLVED = 0x1, ///< Resolved guard record, free to reuse
+    SLOT_MATCH = 0x2,    ///< targetId is the key, same as EntityPath::==
+};
+
+/**
+ * @brief Classify the record slots of the partition image, up to the
+ *        first blank slot
+ *
+ * The slots are checked with the vector instructions, AVX2 if the CPU
+ * supports them and, SSE2, NEON or VSX of the CPU libguard is built for,
+ * otherwise one byte at a time. The record id and the target id are at
+ * the same offsets in all the layouts.
+ *
+ * @param[in] slots image of the consecutive record slots
+ * @param[in] count number of slots in the image
+ * @param[in] slotSize size of a slot
+ * @param[in] blankSize bytes at the start of the slot which are all 0xFF
+ *                      in the blank slot
+ * @param[in] key entity path to match the targetId of the slots with,
+ *                nullptr to not match
+ * @param[out] classes SlotClass of the slots before the first blank slot,
+ *                     must have room for count slots
+ *
+ * @return number of slots before the first blank slot, count if there is
+ *         no blank slot
+ */
+size_t scanSlots(const uint8_t* slots, size_t count, size_t slotSize,
+                 size_t blankSize, const EntityPath* key, uint8_t* classes);
+
+/**
+ * @brief Classify the record slots without the vector instructions, same
+ *        result as scanSlots()
+ */
+size_t scanSlotsPortable(const uint8_t* slots, size_t count, size_t slotSize,
+                         size_t blankSize, const EntityPath* key,
+                         uint8_t* classes);
+} // namespace guard
+} // namespace openpower
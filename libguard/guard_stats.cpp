@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_stats.hpp"
+
+namespace openpower
+{
+namespace guard
+{
+namespace stats
+{
+Counters counters;
+
+void recordLatency(Api api, uint64_t ns)
+{
+    auto& histogram = counters.latency[static_cast<size_t>(api)];
+    add(histogram.count);
+    add(histogram.totalNs, ns);
+
+    uint64_t maxNs = histogram.maxNs.load(std::memory_order_relaxed);
+    while ((ns > maxNs) && !histogram.maxNs.compare_exchange_weak(
+                               maxNs, ns, std::memory_order_relaxed))
+    {
+    }
+
+    // Bucket is the number of bits of the latency in microseconds
+    size_t bucket = 0;
+    for (uint64_t us = ns / 1000; (us != 0) && (bucket < latencyBuckets - 1);
+         us >>= 1)
+    {
+        bucket++;
+    }
+    add(histogram.buckets[bucket]);
+}
+
+const char* apiToStr(Api api)
+{
+    switch (api)
+    {
+        case Api::Create:
+            return "create";
+        case Api::GetAll:
+            return "getAll";
+        case Api::Clear:
+            return "clear";
+        case Api::InvalidateAll:
+            return "invalidateAll";
+        case Api::GetAllSummaries:
+            return "getAllSummaries";
+        default:
+            return "unknown";
+    }
+}
+} // namespace stats
+
+using namespace openpower::guard::stats;
+
+/**
+ * @brief Helper function to read and optionally reset the counter
+ */
+static uint64_t readCounter(std::atomic<uint64_t>& counter, bool reset)
+{
+    if (reset)
+    {
+        return counter.exchange(0, std::memory_order_relaxed);
+    }
+    return counter.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Helper function to get the snapshot and optionally reset the
+ *        counters
+ */
+static GuardStats readCounters(bool reset)
+{
+    GuardStats guardStats{};
+    guardStats.opens = readCounter(counters.opens, reset);
+    guardStats.reads = readCounter(counters.reads, reset);
+    guardStats.writes = readCounter(counters.writes, reset);
+    guardStats.bytesRead = readCounter(counters.bytesRead, reset);
+    guardStats.bytesWritten = readCounter(counters.bytesWritten, reset);
+    guardStats.fsyncs = readCounter(counters.fsyncs, reset);
+    guardStats.recordsScanned = readCounter(counters.recordsScanned, reset);
+    guardStats.devTreeTraversals =
+        readCounter(counters.devTreeTraversals, reset);
+    guardStats.checksumErrors = readCounter(counters.checksumErrors, reset);
+    guardStats.journalDrops = readCounter(counters.journalDrops, reset);
+
+    for (size_t api = 0; api < guardStats.latency.size(); api++)
+    {
+        auto& histogram = counters.latency[api];
+        auto& latency = guardStats.latency[api];
+        latency.count = readCounter(histogram.count, reset);
+        latency.totalNs = readCounter(histogram.totalNs, reset);
+        latency.maxNs = readCounter(histogram.maxNs, reset);
+        for (size_t bucket = 0; bucket < latencyBuckets; bucket++)
+        {
+            latency.buckets[bucket] =
+                readCounter(histogram.buckets[bucket], reset);
+        }
+    }
+    return guardStats;
+}
+
+GuardStats getStats()
+{
+    return readCounters(false);
+}
+
+void resetStats()
+{
+    readCounters(true);
+}
+} // namespace guard
+} // namespace openpower
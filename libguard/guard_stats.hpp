@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace openpower
+{
+namespace guard
+{
+namespace stats
+{
+/**
+ * Number of latency histogram buckets, the bucket N counts the calls
+ * which took less than 2^N microseconds and the last bucket counts the
+ * rest.
+ */
+constexpr size_t latencyBuckets = 16;
+
+/**
+ * @brief Public APIs which are timed
+ */
+enum class Api
+{
+    Create,
+    GetAll,
+    Clear,
+    InvalidateAll,
+    GetAllSummaries,
+    Count
+};
+
+/**
+ * @brief Latency histogram of an API
+ */
+struct LatencyHistogram
+{
+    uint64_t count;   ///< Number of calls
+    uint64_t totalNs; ///< Total time of the calls in nanoseconds
+    uint64_t maxNs;   ///< Longest call in nanoseconds
+    std::array<uint64_t, latencyBuckets> buckets; ///< Calls per bucket
+};
+
+/**
+ * @brief Snapshot of the libguard counters of the process
+ *
+ * @note fsyncs is counted only where libguard explicitly syncs the
+ *       GUARD file to the storage.
+ */
+struct GuardStats
+{
+    uint64_t opens;             ///< GUARD file opens
+    uint64_t reads;             ///< GUARD file reads
+    uint64_t writes;            ///< GUARD file writes
+    uint64_t bytesRead;         ///< Bytes read from the GUARD file
+    uint64_t bytesWritten;      ///< Bytes written to the GUARD file
+    uint64_t fsyncs;            ///< GUARD file syncs
+    uint64_t recordsScanned;    ///< Record slots read from the GUARD file
+    uint64_t devTreeTraversals; ///< Device tree targets traversals
+    uint64_t checksumErrors;    ///< Records skipped for checksum mismatch
+    uint64_t journalDrops;      ///< Discarded guard journal entries
+    std::array<LatencyHistogram, static_cast<size_t>(Api::Count)> latency;
+};
+
+/**
+ * @brief Counters updated by libguard
+ *
+ * The counters are updated without ordering so, the cost is an atomic
+ * add and, the readers can get a snapshot that is not consistent across
+ * the counters while the operations are in progress.
+ */
+struct Counters
+{
+    std::atomic<uint64_t> opens{0};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> writes{0};
+    std::atomic<uint64_t> bytesRead{0};
+    std::atomic<uint64_t> bytesWritten{0};
+    std::atomic<uint64_t> fsyncs{0};
+    std::atomic<uint64_t> recordsScanned{0};
+    std::atomic<uint64_t> devTreeTraversals{0};
+    std::atomic<uint64_t> checksumErrors{0};
+    std::atomic<uint64_t> journalDrops{0};
+
+    struct Histogram
+    {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> totalNs{0};
+        std::atomic<uint64_t> maxNs{0};
+        std::array<std::atomic<uint64_t>, latencyBuckets> buckets{};
+    };
+    std::array<Histogram, static_cast<size_t>(Api::Count)> latency;
+};
+
+extern Counters counters;
+
+/**
+ * @brief Add the given value to the counter
+ *
+ * @param[in] counter counter to update
+ * @param[in] value value to add
+ *
+ * @return NULL
+ */
+inline void add(std::atomic<uint64_t>& counter, uint64_t value = 1)
+{
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Record the latency of a call of the given API
+ *
+ * @param[in] api API which is called
+ * @param[in] ns latency of the call in nanoseconds
+ *
+ * @return NULL
+ */
+void recordLatency(Api api, uint64_t ns);
+
+/**
+ * @class LatencyTimer
+ *
+ * Record the time from the construction to the destruction as the
+ * latency of the given API, including the calls which are failed.
+ */
+class LatencyTimer
+{
+  public:
+    LatencyTimer() = delete;
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+    LatencyTimer(LatencyTimer&&) = delete;
+    LatencyTimer& operator=(LatencyTimer&&) = delete;
+
+    explicit LatencyTimer(Api api) :
+        api(api), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~LatencyTimer()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        recordLatency(api, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               elapsed)
+                               .count());
+    }
+
+  private:
+    Api api;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Return the name of the given API
+ *
+ * @param[in] api API
+ *
+ * @return API name
+ */
+const char* apiToStr(Api api);
+} // namespace stats
+
+/**
+ * @brief Get the libguard I/O counters and API latency histograms of
+ *        the process
+ *
+ * @return snapshot of the counters
+ */
+stats::GuardStats getStats();
+
+/**
+ * @brief Reset the libguard counters of the process to zero
+ *
+ * @return NULL
+ */
+void resetStats();
+} // namespace guard
+} // namespace openpower
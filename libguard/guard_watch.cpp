@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_watch.hpp"
+
+#include "guard_codec.hpp"
+#include "guard_file.hpp"
+#include "guard_interface.hpp"
+#include "guard_interface_impl.hpp"
+#include "guard_log.hpp"
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+namespace openpower
+{
+namespace guard
+{
+namespace
+{
+/**
+ * @brief Return the guard records of the guard file by slot position
+ *
+ * The records which getAll() skips e.g. failing the checksum are kept as
+ * blank slots so, the records after them stay in their slot.
+ *
+ * @param[in] guardFile path of the guard file
+ *
+ * @return guard records in host endianness format, one per slot. Throws
+ *         the guard file exceptions on the I/O failures.
+ */
+GuardRecords readSlots(const fs::path& guardFile)
+{
+    GuardRecords records;
+    GuardFile file(guardFile, getGuardLayout());
+    withCodec(file.layout(), [&](auto codec) {
+        using Codec = decltype(codec);
+        GuardRecord record;
+        GuardRecord blank;
+        memset(&blank, 0xff, sizeof(blank));
+        records.reserve(Codec::slots(file.size()));
+        Codec::scan(file, nullptr, [&](int, uint8_t, const uint8_t* slot) {
+            Codec::decode(slot, record);
+            if constexpr (Codec::isNative)
+            {
+                if (!isRecordIntact(record))
+                {
+                    records.push_back(blank);
+                    return true;
+                }
+            }
+            records.push_back(getHostEndiannessRecord(record));
+            return true;
+        });
+    });
+    return records;
+}
+} // namespace
+
+std::string guardEventToStr(GuardEvent::Type type)
+{
+    switch (type)
+    {
+        case GuardEvent::Type::Added:
+            return "added";
+        case GuardEvent::Type::Resolved:
+            return "resolved";
+        case GuardEvent::Type::Overwritten:
+            return "overwritten";
+    }
+    return "unknown";
+}
+
+GuardWatcher::GuardWatcher() : guardFile(getGuardFilePath())
+{
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to initialize inotify");
+    }
+
+    // Watch the directory so, the guard file replaced by rename is also
+    // noticed
+    auto dir = guardFile.parent_path();
+    if (dir.empty())
+    {
+        dir = ".";
+    }
+    if (inotify_add_watch(inotifyFd, dir.c_str(),
+                          IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO |
+                              IN_CREATE) < 0)
+    {
+        int error = errno;
+        close(inotifyFd);
+        throw std::system_error(error, std::generic_category(),
+                                "Failed to watch the guard file");
+    }
+
+    try
+    {
+        snapshot = readSlots(guardFile);
+    }
+    catch (...)
+    {
+        close(inotifyFd);
+        throw;
+    }
+}
+
+GuardWatcher::~GuardWatcher()
+{
+    close(inotifyFd);
+}
+
+int GuardWatcher::subscribe(Callback callback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    int id = nextId++;
+    callbacks.emplace(id, std::move(callback));
+    return id;
+}
+
+void GuardWatcher::unsubscribe(int id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    callbacks.erase(id);
+}
+
+int GuardWatcher::fd() const
+{
+    return inotifyFd;
+}
+
+void GuardWatcher::process()
+{
+    alignas(struct inotify_event) char buf[4096];
+    bool changed = false;
+    auto fileName = guardFile.filename();
+    while (true)
+    {
+        ssize_t len = read(inotifyFd, buf, sizeof(buf));
+        if (len <= 0)
+        {
+            // No more events, EAGAIN
+            break;
+        }
+
+        for (ssize_t pos = 0; pos < len;)
+        {
+            const auto* event =
+                reinterpret_cast<const struct inotify_event*>(buf + pos);
+            if ((event->len > 0) && (fileName == event->name))
+            {
+                changed = true;
+            }
+            pos += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    if (changed)
+    {
+        refresh();
+    }
+}
+
+bool GuardWatcher::wait(int timeoutMs)
+{
+    struct pollfd pfd = {inotifyFd, POLLIN, 0};
+    int rc = poll(&pfd, 1, timeoutMs);
+    if (rc < 0)
+    {
+        if (errno == EINTR)
+        {
+            return true;
+        }
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to wait for the guard file change");
+    }
+    if (rc == 0)
+    {
+        return false;
+    }
+    process();
+    return true;
+}
+
+void GuardWatcher::refresh()
+{
+    GuardRecords records;
+    try
+    {
+        records = readSlots(guardFile);
+    }
+    catch (const std::exception& ex)
+    {
+        // The guard file may be in the middle of replacing, the next
+        // change will read it again
+        GUARD_LOG(GUARD_ERROR, "Failed to read the changed guard file: %s",
+                  ex.what());
+        return;
+    }
+
+    auto events = diff(snapshot, records);
+    snapshot = std::move(records);
+    if (events.empty())
+    {
+        return;
+    }
+
+    std::map<int, Callback> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        subscribers = callbacks;
+    }
+    for (const auto& subscriber : subscribers)
+    {
+        subscriber.second(events);
+    }
+}
+
+GuardEvents GuardWatcher::diff(const GuardRecords& before,
+                               const GuardRecords& after)
+{
+    GuardEvents events;
+    GuardRecord blank;
+    memset(&blank, 0xff, sizeof(blank));
+
+    size_t slots = std::max(before.size(), after.size());
+    for (size_t i = 0; i < slots; i++)
+    {
+        const auto& previous = (i < before.size()) ? before[i] : blank;
+        const auto& current = (i < after.size()) ? after[i] : blank;
+        bool wasLive = (i < before.size()) &&
+                       (previous.recordId != GUARD_RESOLVED);
+        bool isLive =
+            (i < after.size()) && (current.recordId != GUARD_RESOLVED);
+
+        if (wasLive && isLive && (previous.recordId == current.recordId) &&
+            (previous.targetId == current.targetId))
+        {
+            if ((previous.errType != current.errType) ||
+                (previous.elogId != current.elogId))
+            {
+                events.push_back(
+                    {GuardEvent::Type::Overwritten, current, previous});
+            }
+            continue;
+        }
+
+        // The slot is resolved, erased or reused by another record
+        if (wasLive)
+        {
+            events.push_back({GuardEvent::Type::Resolved, previous, previous});
+        }
+        if (isLive)
+        {
+            events.push_back({GuardEvent::Type::Added, current, previous});
+        }
+    }
+    return events;
+}
+} // namespace guard
+} // namespace openpower
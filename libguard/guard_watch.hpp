@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "include/guard_record.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openpower
+{
+namespace guard
+{
+namespace fs = std::filesystem;
+
+/**
+ * @brief Change of a guard record
+ */
+struct GuardEvent
+{
+    /**
+     * Added       - The record is created, including in a reused slot.
+     * Resolved    - The record is resolved or erased.
+     * Overwritten - The type or the error log of the record is changed,
+     *               e.g. manual guard is overwritten by predictive guard.
+     */
+    enum class Type
+    {
+        Added,
+        Resolved,
+        Overwritten
+    };
+
+    Type type;
+
+    /**
+     * Record after the change for Added and Overwritten. Record before the
+     * change for Resolved, so the record id is known. In host endianness.
+     */
+    GuardRecord record;
+
+    /**
+     * Record in the slot before the change, blank for the empty slot
+     */
+    GuardRecord previous;
+};
+
+using GuardEvents = std::vector<GuardEvent>;
+
+/**
+ * @brief Return the name of the guard record change
+ *
+ * @param[in] type type of the change
+ *
+ * @return name of the change
+ */
+std::string guardEventToStr(GuardEvent::Type type);
+
+/**
+ * @class GuardWatcher
+ *
+ * Watch the guard file in use with inotify and, deliver only the changed
+ * records to the subscribers instead of reading all the records
+ * periodically. The changes are computed against the records read when
+ * the guard file was changed last time.
+ *
+ * The watcher does not start a thread, the application either waits for
+ * the changes with wait() or, adds fd() to its event loop and calls
+ * process() when it is readable. The subscribers are called from there.
+ */
+class GuardWatcher
+{
+  public:
+    using Callback = std::function<void(const GuardEvents& events)>;
+
+    GuardWatcher(const GuardWatcher&) = delete;
+    GuardWatcher& operator=(const GuardWatcher&) = delete;
+    GuardWatcher(GuardWatcher&&) = delete;
+    GuardWatcher& operator=(GuardWatcher&&) = delete;
+
+    /**
+     * @brief Constructor, reads the records and starts watching the guard
+     *        file in use i.e. libguard_init() must be called already
+     *
+     * Throws std::system_error if the inotify watch is failed and, the
+     * getAll() exceptions.
+     */
+    GuardWatcher();
+
+    /**
+     * @brief Destructor, stops watching the guard file
+     */
+    ~GuardWatcher();
+
+    /**
+     * @brief Subscribe to the changes of the guard records
+     *
+     * @param[in] callback called with the changes
+     *
+     * @return subscription id to unsubscribe
+     */
+    int subscribe(Callback callback);
+
+    /**
+     * @brief Unsubscribe from the changes of the guard records
+     *
+     * @param[in] id subscription id returned by subscribe()
+     *
+     * @return NULL
+     */
+    void unsubscribe(int id);
+
+    /**
+     * @brief Return the inotify file descriptor to poll for readability
+     */
+    int fd() const;
+
+    /**
+     * @brief Read the pending inotify events without blocking and, deliver
+     *        the changed records if the guard file is changed
+     *
+     * @return NULL
+     */
+    void process();
+
+    /**
+     * @brief Wait for the guard file changes and process them
+     *
+     * @param[in] timeoutMs time to wait in milliseconds, -1 to wait
+     *                      forever
+     *
+     * @return false if the timeout is expired
+     */
+    bool wait(int timeoutMs);
+
+    /**
+     * @brief Return the changes between the given snapshots of the guard
+     *        records, which are compared slot by slot
+     *
+     * @param[in] before records before the change, one per slot
+     * @param[in] after records after the change, one per slot
+     *
+     * @return changes of the records, in the slot order
+     */
+    static GuardEvents diff(const GuardRecords& before,
+                            const GuardRecords& after);
+
+  private:
+    void refresh();
+
+    fs::path guardFile;
+    int inotifyFd = -1;
+    GuardRecords snapshot; ///< Guard records by slot position
+
+    std::mutex mutex;
+    std::map<int, Callback> callbacks;
+    int nextId = 0;
+};
+} // namespace guard
+} // namespace openpower
@@ -2,6 +2,7 @@
 #pragma once
 #include "../guard_common.hpp"
 
+#include <memory_resource>
 #include <vector>
 
 namespace openpower
@@ -14,6 +15,27 @@ namespace guard
 const uint8_t CURRENT_GARD_VERSION_LAYOUT = 0x2;
 #define GUARD_RESOLVED 0xFFFFFFFF
 
+/**
+ * Layouts of the GUARD partition
+ *
+ * Standard - "GUARDREC" header followed by 128 bytes records.
+ * PGuard   - No header, 37 bytes records.
+ *
+ * The layout is detected from the partition, GuardRecord has the layout
+ * of the build and, the records of the other layout are converted.
+ */
+enum class GuardLayout : uint8_t
+{
+    Standard,
+    PGuard
+};
+
+#ifdef PGUARD
+constexpr GuardLayout defaultGuardLayout = GuardLayout::PGuard;
+#else
+constexpr GuardLayout defaultGuardLayout = GuardLayout::Standard;
+#endif
+
 #ifdef PGUARD
 /* From hostboot: src/include/usr/hwas/common/deconfigGard.H:GuardRecord */
 struct GuardRecord
@@ -63,6 +85,20 @@ struct GuardRecord
     } u;
     uint8_t padding[18]; ///< Padding
 } __attribute__((__packed__));
+
+/**
+ * Layout of the end of GuardRecord::padding with the record checksum,
+ * which is present only if the marker is set. The padding is 0xFF
+ * otherwise, as written by Hostboot. The checksum is the CRC32C of the
+ * record up to the checksum, in big endian.
+ */
+struct GuardRecordCrc
+{
+    uint8_t marker; ///< GUARD_RECORD_CRC_MARKER
+    uint32_t crc;   ///< CRC32C of the record before the checksum
+} __attribute__((__packed__));
+
+const uint8_t GUARD_RECORD_CRC_MARKER = 0xC3;
 #endif
 
 struct GuardRecord_t
@@ -73,6 +109,23 @@ struct GuardRecord_t
     GuardRecord* iv_guardRecords; ///< List of guard records
 };
 
+/**
+ * Layout of GuardRecord_t::iv_padding with the header extension, which is
+ * valid only with CURRENT_GARD_VERSION_LAYOUT and the revision below. The
+ * padding is 0xFF otherwise, as written by Hostboot. The values are in big
+ * endian and, they are only the hints which are validated against the
+ * records before using.
+ */
+struct GuardHeaderExt
+{
+    uint8_t revision;       ///< GUARD_HEADER_EXT_REVISION
+    uint16_t usedSlots;     ///< Number of slots before the first blank slot
+    uint16_t resolvedSlots; ///< Resolved slots in use, free to reuse
+    uint16_t nextRecordId;  ///< High-water mark of the record id
+} __attribute__((__packed__));
+
+const uint8_t GUARD_HEADER_EXT_REVISION = 0x1;
+
 /* From hostboot: src/include/usr/hwas/common/hwasCallout.H */
 enum GardType
 {
@@ -91,5 +144,19 @@ enum GardType
 };
 
 using GuardRecords = std::vector<GuardRecord>;
+
+/**
+ * Fields of the guard record which are needed to list the guard records,
+ * without the FRU VPD and the padding. In host endianness.
+ */
+struct GuardRecordSummary
+{
+    uint32_t recordId;   ///< id of the guard record
+    uint32_t elogId;     ///< Id of the error which initiated the guarding
+    EntityPath targetId; ///< Physical path of the target being guarded
+    uint8_t errType;     ///< from hwasCallout.H GUARD_ErrorType
+};
+
+using GuardRecordSummaries = std::pmr::vector<GuardRecordSummary>;
 } // namespace guard
 } // namespace openpower
@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "fake_devtree.hpp"
+
+#include "attributes_info.H"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct pdbg_target
+{
+    std::string physStringPath;          ///< Empty if no physical path
+    std::vector<uint8_t> physBinaryPath; ///< ATTR_PHYS_BIN_PATH value
+    std::string serialNum;               ///< Empty if the target is not FRU
+    std::string partNum;                 ///< Empty if the target is not FRU
+};
+
+namespace openpower
+{
+namespace guard
+{
+namespace fakedt
+{
+/**
+ * The synthetic device tree targets in depth first order, loaded from
+ * the PDBG_DTB file by pdbg_targets_init().
+ */
+static std::vector<pdbg_target> g_targets;
+static std::atomic<size_t> g_traversalCount{0};
+static std::atomic<size_t> g_initCount{0};
+
+/**
+ * Target types from attributes_info.H, used in the physical path binary
+ * value as per the hostboot entity path format.
+ */
+constexpr uint8_t typeSys = 0x01;
+constexpr uint8_t typeNode = 0x02;
+constexpr uint8_t typeProc = 0x05;
+constexpr uint8_t typeCore = 0x07;
+constexpr uint8_t typeEq = 0x23;
+constexpr uint8_t typeFc = 0x53;
+constexpr uint8_t pathTypePhysical = 0x20;
+constexpr size_t coresPerFc = 2;
+constexpr size_t coresPerEq = 4;
+constexpr const char* fruPartNum = "02WG678";
+
+/**
+ * @brief Write the target into the synthetic device tree file
+ *
+ * Format: "<ATTR_PHYS_DEV_PATH> <ATTR_PHYS_BIN_PATH bytes in hex>
+ *          [sn=<ATTR_SERIAL_NUMBER> pn=<ATTR_PART_NUMBER>]"
+ */
+static void writeTarget(std::ofstream& file, const std::string& physPath,
+                        const std::vector<uint8_t>& elements,
+                        const std::string& serialNum = "")
+{
+    file << "physical:" << physPath << " " << std::hex
+         << (pathTypePhysical | (elements.size() / 2));
+    for (auto byte : elements)
+    {
+        file << " " << static_cast<int>(byte);
+    }
+    file << std::dec;
+    if (!serialNum.empty())
+    {
+        file << " sn=" << serialNum << " pn=" << fruPartNum;
+    }
+    file << "\n";
+}
+
+std::string fruSerialNumber(size_t node, size_t proc)
+{
+    char serialNum[16];
+    std::snprintf(serialNum, sizeof(serialNum), "YA30%02zu%02zu0000",
+                  node % 100, proc % 100);
+    return serialNum;
+}
+
+size_t generateDevTree(const fs::path& file, const Topology& topology)
+{
+    std::ofstream dtb(file, std::ios::out | std::ios::trunc);
+    size_t targets = 0;
+
+    std::vector<uint8_t> path{typeSys, 0};
+    writeTarget(dtb, "sys-0", path);
+    targets++;
+    for (size_t node = 0; node < topology.nodes; node++)
+    {
+        std::string nodePath = "sys-0/node-" + std::to_string(node);
+        path = {typeSys, 0, typeNode, static_cast<uint8_t>(node)};
+        writeTarget(dtb, nodePath, path);
+        targets++;
+
+        for (size_t proc = 0; proc < topology.procs; proc++)
+        {
+            std::string procPath = nodePath + "/proc-" + std::to_string(proc);
+            path.resize(4);
+            path.insert(path.end(), {typeProc, static_cast<uint8_t>(proc)});
+            writeTarget(dtb, procPath, path, fruSerialNumber(node, proc));
+            targets++;
+
+            // Target without physical path e.g. fsi, pib
+            dtb << "-\n";
+
+            for (size_t core = 0; core < topology.cores; core++)
+            {
+                auto eq = static_cast<uint8_t>(core / coresPerEq);
+                auto fc = static_cast<uint8_t>((core / coresPerFc) %
+                                               (coresPerEq / coresPerFc));
+                auto unit = static_cast<uint8_t>(core % coresPerFc);
+                std::string eqPath = procPath + "/eq-" + std::to_string(eq);
+                std::string fcPath = eqPath + "/fc-" + std::to_string(fc);
+
+                path.resize(6);
+                path.insert(path.end(), {typeEq, eq});
+                if ((core % coresPerEq) == 0)
+                {
+                    writeTarget(dtb, eqPath, path);
+                    targets++;
+                }
+                path.insert(path.end(), {typeFc, fc});
+                if ((core % coresPerFc) == 0)
+                {
+                    writeTarget(dtb, fcPath, path);
+                    targets++;
+                }
+                path.insert(path.end(), {typeCore, unit});
+                writeTarget(dtb, fcPath + "/core-" + std::to_string(unit),
+                            path);
+                targets++;
+            }
+        }
+    }
+
+    return targets;
+}
+
+size_t traversalCount()
+{
+    return g_traversalCount;
+}
+
+size_t initCount()
+{
+    return g_initCount;
+}
+
+int getProperty(const char* name, struct pdbg_target* target, void* val,
+                size_t size)
+{
+    if ((std::strcmp(name, "ATTR_PHYS_DEV_PATH") != 0) ||
+        target->physStringPath.empty())
+    {
+        return 1;
+    }
+    std::memset(val, 0, size);
+    std::strncpy(static_cast<char*>(val), target->physStringPath.c_str(),
+                 size - 1);
+    return 0;
+}
+} // namespace fakedt
+} // namespace guard
+} // namespace openpower
+
+using namespace openpower::guard::fakedt;
+
+extern "C"
+{
+    void pdbg_set_loglevel(enum pdbg_log_level)
+    {}
+
+    bool pdbg_targets_init(void*)
+    {
+        g_initCount++;
+        g_targets.clear();
+
+        const char* dtbPath = std::getenv("PDBG_DTB");
+        if (dtbPath == nullptr)
+        {
+            return false;
+        }
+
+        std::ifstream dtb(dtbPath);
+        std::string line;
+        while (std::getline(dtb, line))
+        {
+            pdbg_target target;
+            std::istringstream fields(line);
+            std::string physPath;
+            fields >> physPath;
+            if (physPath != "-")
+            {
+                target.physStringPath = physPath;
+                std::string field;
+                while (fields >> field)
+                {
+                    if (field.rfind("sn=", 0) == 0)
+                    {
+                        target.serialNum = field.substr(3);
+                    }
+                    else if (field.rfind("pn=", 0) == 0)
+                    {
+                        target.partNum = field.substr(3);
+                    }
+                    else
+                    {
+                        target.physBinaryPath.push_back(
+                            std::stoi(field, nullptr, 16));
+                    }
+                }
+                target.physBinaryPath.resize(sizeof(ATTR_PHYS_BIN_PATH_Type));
+            }
+            g_targets.push_back(std::move(target));
+        }
+        return dtb.eof();
+    }
+
+    int pdbg_target_traverse(struct pdbg_target* target,
+                             pdbg_target_traverse_callback cb, void* priv)
+    {
+        // Only traversal from the root is used by libguard
+        if (target != nullptr)
+        {
+            return 0;
+        }
+
+        g_traversalCount++;
+        for (auto& child : g_targets)
+        {
+            int ret = cb(&child, priv);
+            if (ret != 0)
+            {
+                return ret;
+            }
+        }
+        return 0;
+    }
+
+    bool pdbg_target_get_attribute(struct pdbg_target* target,
+                                   const char* name, uint32_t size,
+                                   uint32_t count, void* val)
+    {
+        const std::string* vpd = nullptr;
+        if (std::strcmp(name, "ATTR_SERIAL_NUMBER") == 0)
+        {
+            vpd = &target->serialNum;
+        }
+        else if (std::strcmp(name, "ATTR_PART_NUMBER") == 0)
+        {
+            vpd = &target->partNum;
+        }
+        if (vpd != nullptr)
+        {
+            if (vpd->empty() || (vpd->size() > size * count))
+            {
+                return false;
+            }
+            std::memset(val, 0, size * count);
+            std::memcpy(val, vpd->data(), vpd->size());
+            return true;
+        }
+
+        if ((std::strcmp(name, "ATTR_PHYS_BIN_PATH") != 0) ||
+            target->physBinaryPath.empty() ||
+            (size * count != target->physBinaryPath.size()))
+        {
+            return false;
+        }
+        std::memcpy(val, target->physBinaryPath.data(),
+                    target->physBinaryPath.size());
+        return true;
+    }
+}
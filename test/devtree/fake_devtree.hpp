@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace openpower
+{
+namespace guard
+{
+namespace fakedt
+{
+namespace fs = std::filesystem;
+
+/**
+ * @brief Size of the synthetic system
+ *
+ * Every processor has "cores" cores and the eq/fc targets containing
+ * them, the same as the power10 physical path hierarchy i.e.
+ * sys-0/node-N/proc-N/eq-N/fc-N/core-N
+ */
+struct Topology
+{
+    size_t nodes;
+    size_t procs; ///< processors per node
+    size_t cores; ///< cores per processor
+};
+
+/**
+ * @brief Generate a synthetic device tree file
+ *
+ * The generated file is used by the stand-in of pdbg_targets_init()
+ * through PDBG_DTB, the same as the real system device tree.
+ *
+ * @param[in] file the file to write
+ * @param[in] topology size of the system
+ *
+ * @return number of targets having physical path attributes
+ */
+size_t generateDevTree(const fs::path& file, const Topology& topology);
+
+/**
+ * @brief Return the serial number of the given processor FRU
+ *
+ * The processors are the FRU in the synthetic device tree and the
+ * other targets are using the VPD of the processor containing them.
+ */
+std::string fruSerialNumber(size_t node, size_t proc);
+
+/**
+ * @brief Return the number of device tree traversals done from the root
+ */
+size_t traversalCount();
+
+/**
+ * @brief Return the number of pdbg_targets_init() calls
+ */
+size_t initCount();
+} // namespace fakedt
+} // namespace guard
+} // namespace openpower
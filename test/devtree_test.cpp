@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "devtree/fake_devtree.hpp"
+#include "libguard/devtree/phal_devtree.hpp"
+#include "libguard/guard_stats.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace fakedt = openpower::guard::fakedt;
+namespace phal = openpower::guard::phal;
+
+class TestDevTree : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/FakeDevTree.XXXXXX";
+        auto dirPtr = mkdtemp(dirTemplate);
+        if (dirPtr == NULL)
+        {
+            throw std::bad_alloc();
+        }
+        dtbDir = std::string(dirPtr);
+        dtbFile = dtbDir;
+        dtbFile /= "system.dtb";
+        setenv("PDBG_DTB", dtbFile.c_str(), 1);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(dtbDir);
+    }
+
+    /**
+     * @brief Generate the synthetic device tree and init phal with it
+     *
+     * @return number of targets having physical path
+     */
+    size_t initDevTree(const fakedt::Topology& topology)
+    {
+        size_t targets = fakedt::generateDevTree(dtbFile, topology);
+        phal::initPHAL();
+        return targets;
+    }
+
+  protected:
+    fs::path dtbDir;
+    fs::path dtbFile;
+};
+
+TEST_F(TestDevTree, PhysicalPathConversion)
+{
+    initDevTree({1, 2, 8});
+
+    std::string physPath{"physical:sys-0/node-0/proc-1/eq-1/fc-0/core-1"};
+    auto entityPath = phal::getEntityPathFromDevTree(physPath);
+    ASSERT_NE(entityPath, std::nullopt);
+    openpower::guard::EntityPath expected = {0x26, 0x01, 0x00, 0x02, 0x00,
+                                             0x05, 0x01, 0x23, 0x01, 0x53,
+                                             0x00, 0x07, 0x01};
+    EXPECT_EQ(*entityPath, expected);
+    EXPECT_EQ(phal::getPhysicalPathFromDevTree(*entityPath), physPath);
+
+    // All the supported physical path formats
+    EXPECT_EQ(phal::getEntityPathFromDevTree(
+                  "/sys-0/node-0/proc-1/eq-1/fc-0/core-1"),
+              entityPath);
+    EXPECT_EQ(
+        phal::getEntityPathFromDevTree("sys-0/node-0/proc-1/eq-1/fc-0/core-1"),
+        entityPath);
+    EXPECT_EQ(phal::getEntityPathFromDevTree(
+                  "PHYSICAL:SYS-0/NODE-0/PROC-1/EQ-1/FC-0/CORE-1"),
+              entityPath);
+}
+
+TEST_F(TestDevTree, PhysicalPathNotFound)
+{
+    initDevTree({1, 2, 8});
+
+    EXPECT_EQ(phal::getEntityPathFromDevTree("/sys-0/node-0/proc-2"),
+              std::nullopt);
+    EXPECT_EQ(phal::getEntityPathFromDevTree(std::string(100, 'a')),
+              std::nullopt);
+    openpower::guard::EntityPath unknown = {0x23, 0x01, 0x00, 0x02,
+                                            0x00, 0x05, 0x07};
+    EXPECT_EQ(phal::getPhysicalPathFromDevTree(unknown), std::nullopt);
+}
+
+TEST_F(TestDevTree, FruVpd)
+{
+    initDevTree({2, 2, 8});
+
+    auto entityPath = phal::getEntityPathFromDevTree(
+        "/sys-0/node-1/proc-1/eq-1/fc-0/core-1");
+    ASSERT_NE(entityPath, std::nullopt);
+    auto fruVpd = phal::getFruVpdFromDevTree(*entityPath);
+    ASSERT_NE(fruVpd, std::nullopt);
+
+    // The core is using the VPD of the processor containing it
+    std::string serialNum = fakedt::fruSerialNumber(1, 1);
+    EXPECT_EQ(std::string(fruVpd->serialNum.begin(), fruVpd->serialNum.end()),
+              serialNum);
+    EXPECT_EQ(std::string(fruVpd->partNum.begin(), fruVpd->partNum.end()),
+              "02WG678");
+
+    // The targets above the FRU are not having VPD
+    entityPath = phal::getEntityPathFromDevTree("/sys-0/node-1");
+    ASSERT_NE(entityPath, std::nullopt);
+    EXPECT_EQ(phal::getFruVpdFromDevTree(*entityPath), std::nullopt);
+}
+
+TEST_F(TestDevTree, DeviceTreeTraversedOnce)
+{
+    initDevTree({2, 4, 16});
+    size_t traversals = fakedt::traversalCount();
+    auto devTreeTraversals = openpower::guard::getStats().devTreeTraversals;
+    EXPECT_GE(devTreeTraversals, 1);
+
+    std::vector<openpower::guard::EntityPath> entityPaths;
+    for (size_t proc = 0; proc < 4; proc++)
+    {
+        auto entityPath = phal::getEntityPathFromDevTree(
+            "/sys-0/node-1/proc-" + std::to_string(proc));
+        ASSERT_NE(entityPath, std::nullopt);
+        entityPaths.push_back(*entityPath);
+    }
+    auto physPaths = phal::getPhysicalPathsFromDevTree(entityPaths);
+    ASSERT_EQ(physPaths.size(), entityPaths.size());
+    EXPECT_EQ(physPaths[3], "physical:sys-0/node-1/proc-3");
+
+    EXPECT_EQ(fakedt::traversalCount(), traversals);
+    EXPECT_EQ(openpower::guard::getStats().devTreeTraversals,
+              devTreeTraversals);
+}
+
+TEST_F(TestDevTree, ParallelLookups)
+{
+    initDevTree({2, 4, 32});
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> failures(8, 0);
+    for (size_t i = 0; i < failures.size(); i++)
+    {
+        threads.emplace_back([i, &failures]() {
+            for (size_t core = 0; core < 32; core++)
+            {
+                std::string physPath =
+                    "physical:sys-0/node-" + std::to_string(i % 2) +
+                    "/proc-" + std::to_string(i % 4) + "/eq-" +
+                    std::to_string(core / 4) + "/fc-" +
+                    std::to_string((core / 2) % 2) + "/core-" +
+                    std::to_string(core % 2);
+                auto entityPath = phal::getEntityPathFromDevTree(physPath);
+                if (!entityPath ||
+                    (phal::getPhysicalPathFromDevTree(*entityPath) !=
+                     physPath))
+                {
+                    failures[i]++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto failure : failures)
+    {
+        EXPECT_EQ(failure, 0);
+    }
+}
+
+TEST_F(TestDevTree, LookupLatencyScaling)
+{
+    using clock = std::chrono::steady_clock;
+    const std::vector<fakedt::Topology> topologies = {
+        {1, 1, 8}, {1, 4, 32}, {4, 8, 32}, {8, 16, 48}};
+
+    for (const auto& topology : topologies)
+    {
+        auto start = clock::now();
+        size_t targets = initDevTree(topology);
+        auto initTime = clock::now() - start;
+
+        // Look up every core of the last processor in both directions
+        std::vector<std::string> physPaths;
+        for (size_t core = 0; core < topology.cores; core++)
+        {
+            physPaths.push_back(
+                "/sys-0/node-" + std::to_string(topology.nodes - 1) +
+                "/proc-" + std::to_string(topology.procs - 1) + "/eq-" +
+                std::to_string(core / 4) + "/fc-" +
+                std::to_string((core / 2) % 2) + "/core-" +
+                std::to_string(core % 2));
+        }
+
+        start = clock::now();
+        std::vector<openpower::guard::EntityPath> entityPaths;
+        for (const auto& physPath : physPaths)
+        {
+            auto entityPath = phal::getEntityPathFromDevTree(physPath);
+            ASSERT_NE(entityPath, std::nullopt);
+            entityPaths.push_back(*entityPath);
+        }
+        auto toBinaryTime = clock::now() - start;
+
+        start = clock::now();
+        for (const auto& entityPath : entityPaths)
+        {
+            ASSERT_NE(phal::getPhysicalPathFromDevTree(entityPath),
+                      std::nullopt);
+        }
+        auto toStringTime = clock::now() - start;
+
+        auto nsPerLookup = [&physPaths](clock::duration time) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(time)
+                       .count() /
+                   static_cast<long long>(physPaths.size());
+        };
+        std::string name = std::to_string(topology.nodes) + "x" +
+                           std::to_string(topology.procs) + "x" +
+                           std::to_string(topology.cores);
+        std::cout << "devtree " << name << ": targets=" << targets
+                  << " init_us="
+                  << std::chrono::duration_cast<std::chrono::microseconds>(
+                         initTime)
+                         .count()
+                  << " to_binary_ns=" << nsPerLookup(toBinaryTime)
+                  << " to_string_ns=" << nsPerLookup(toStringTime)
+                  << std::endl;
+        RecordProperty(name + "_to_binary_ns", nsPerLookup(toBinaryTime));
+        RecordProperty(name + "_to_string_ns", nsPerLookup(toStringTime));
+    }
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_test_fixture.hpp"
+#include "libguard/guard_async.hpp"
+#include "libguard/guard_entity.hpp"
+#include "libguard/guard_exception.hpp"
+#include "libguard/guard_interface.hpp"
+#include "libguard/guard_stats.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace guard = openpower::guard;
+
+class TestAsyncGuard : public InitializedGuardFileTest
+{
+};
+
+TEST_F(TestAsyncGuard, CreateAndClear)
+{
+    guard::AsyncGuard asyncGuard;
+    auto created = asyncGuard.create(dimm(0));
+    auto cleared = asyncGuard.clear(dimm(0));
+    auto notFound = asyncGuard.clear(0x20);
+
+    EXPECT_EQ(created.get().recordId, 1);
+    EXPECT_NO_THROW(cleared.get());
+    EXPECT_THROW(notFound.get(), guard::exception::InvalidEntityPath);
+
+    guard::GuardRecords records = guard::getAll();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].recordId, GUARD_RESOLVED);
+}
+
+TEST_F(TestAsyncGuard, CoalesceAdjacentRecords)
+{
+    guard::AsyncGuard asyncGuard;
+
+    // The first callback blocks the worker until the rest are queued
+    std::promise<void> release;
+    auto released = release.get_future();
+    asyncGuard.create(dimm(0), 0, guard::GARD_User_Manual, true,
+                      [&released](const guard::GuardRecord&,
+                                  std::error_code) { released.wait(); });
+    std::vector<std::error_code> errors;
+    for (int i = 1; i < 4; i++)
+    {
+        asyncGuard.create(dimm(i), 0, guard::GARD_User_Manual, true,
+                          [&errors](const guard::GuardRecord&,
+                                    std::error_code ec) {
+                              errors.push_back(ec);
+                          });
+    }
+    guard::resetStats();
+    release.set_value();
+    asyncGuard.flush();
+
+    ASSERT_EQ(errors.size(), 3);
+    for (const auto& ec : errors)
+    {
+        EXPECT_FALSE(ec);
+    }
+    // The 3 records are written at once
+    EXPECT_EQ(guard::getStats().writes, 1);
+    EXPECT_EQ(guard::getAll().size(), 4);
+}
+
+TEST_F(TestAsyncGuard, RejectWhenFull)
+{
+    guard::AsyncGuard asyncGuard(1, guard::AsyncGuard::Overflow::Reject);
+
+    std::promise<void> release;
+    auto released = release.get_future();
+    asyncGuard.create(dimm(0), 0, guard::GARD_User_Manual, true,
+                      [&released](const guard::GuardRecord&,
+                                  std::error_code) { released.wait(); });
+    // Wait until the worker takes the first operation
+    std::error_code ec;
+    while (!ec)
+    {
+        asyncGuard.clear(0x20, false,
+                         [&ec](std::error_code result) { ec = result; });
+    }
+    EXPECT_EQ(ec, std::errc::resource_unavailable_try_again);
+
+    release.set_value();
+    asyncGuard.shutdown();
+    auto canceled = asyncGuard.create(dimm(1));
+    EXPECT_THROW(canceled.get(), std::system_error);
+}
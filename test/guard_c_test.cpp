@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_test_fixture.hpp"
+#include "libguard/guard_c.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+// The C record does not depend on the layout libguard is built for
+static_assert(sizeof(guard_record) == 128);
+static_assert(offsetof(guard_record, err_type) == 29);
+
+// Count the allocations to check the C API does not allocate
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    allocations++;
+    void* ptr = std::malloc(size != 0 ? size : 1);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+class TestGuardC : public GuardFileTest
+{
+};
+
+TEST_F(TestGuardC, CreateListClear)
+{
+    guard_handle_t handle;
+    ASSERT_EQ(guard_open(&handle, guardFile.c_str()), GUARD_STATUS_OK);
+
+    guard_entity_path dimm0;
+    guard_entity_path dimm1;
+    ASSERT_EQ(guard_get_entity_path("/sys-0/node-0/dimm-0", &dimm0),
+              GUARD_STATUS_OK);
+    ASSERT_EQ(guard_get_entity_path("/sys-0/node-0/dimm-1", &dimm1),
+              GUARD_STATUS_OK);
+
+    size_t before = allocations;
+    guard_record record;
+    EXPECT_EQ(guard_create(&handle, &dimm0, 0x10, 0xD2 /* manual */, 1,
+                           &record),
+              GUARD_STATUS_OK);
+    EXPECT_EQ(record.record_id, 1);
+    EXPECT_EQ(record.elog_id, 0x10);
+    EXPECT_EQ(guard_create(&handle, &dimm1, 0x20, 0xD2, 1, nullptr),
+              GUARD_STATUS_OK);
+
+    guard_record records[4];
+    size_t count = 0;
+    EXPECT_EQ(guard_get_all(&handle, 0, records, 4, &count), GUARD_STATUS_OK);
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(records[1].record_id, 2);
+    EXPECT_EQ(records[1].elog_id, 0x20);
+    EXPECT_EQ(memcmp(&records[1].target_id, &dimm1, sizeof(dimm1)), 0);
+    EXPECT_EQ(records[1].err_type, 0xD2);
+
+    // Only the first record fits
+    EXPECT_EQ(guard_get_all(&handle, 0, records, 1, &count),
+              GUARD_STATUS_BUFFER_TOO_SMALL);
+    EXPECT_EQ(count, 2);
+
+    EXPECT_EQ(guard_clear_by_id(&handle, 1, 0), GUARD_STATUS_OK);
+    EXPECT_EQ(guard_clear_by_path(&handle, &dimm1, 0), GUARD_STATUS_OK);
+    EXPECT_EQ(guard_get_all(&handle, 0, records, 4, &count), GUARD_STATUS_OK);
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(records[0].record_id, 0xFFFFFFFF);
+
+    char path[64];
+    size_t length = 0;
+    EXPECT_EQ(guard_get_physical_path(&dimm1, path, sizeof(path), &length),
+              GUARD_STATUS_OK);
+    EXPECT_STREQ(path, "/sys-0/node-0/dimm-1");
+    EXPECT_EQ(length, strlen(path));
+    EXPECT_EQ(guard_get_physical_path(&dimm1, path, 4, &length),
+              GUARD_STATUS_BUFFER_TOO_SMALL);
+    EXPECT_EQ(length, strlen("/sys-0/node-0/dimm-1"));
+    EXPECT_EQ(allocations, before);
+
+    EXPECT_EQ(guard_clear_by_id(&handle, 1, 0),
+              GUARD_STATUS_INVALID_ENTITY_PATH);
+
+    EXPECT_EQ(guard_clear_all(&handle), GUARD_STATUS_OK);
+    EXPECT_EQ(guard_get_all(&handle, 0, nullptr, 0, &count), GUARD_STATUS_OK);
+    EXPECT_EQ(count, 0);
+    EXPECT_EQ(guard_close(&handle), GUARD_STATUS_OK);
+}
+
+TEST_F(TestGuardC, StatusCodes)
+{
+    guard_handle_t handle;
+    std::string notExist = guardDir + "/NotExist";
+    EXPECT_EQ(guard_open(&handle, notExist.c_str()),
+              GUARD_STATUS_GUARD_FILE_OPEN_FAILED);
+    EXPECT_EQ(guard_invalidate_all(&handle), GUARD_STATUS_INVALID_ARGUMENT);
+
+    ASSERT_EQ(guard_open(&handle, guardFile.c_str()), GUARD_STATUS_OK);
+    guard_entity_path dimm0;
+    ASSERT_EQ(guard_get_entity_path("/sys-0/node-0/dimm-0", &dimm0),
+              GUARD_STATUS_OK);
+    EXPECT_EQ(guard_create(&handle, &dimm0, 0, 0xE6 /* predictive */, 0,
+                           nullptr),
+              GUARD_STATUS_OK);
+    EXPECT_EQ(guard_create(&handle, &dimm0, 0, 0xE6, 0, nullptr),
+              GUARD_STATUS_ALREADY_GUARDED);
+    EXPECT_EQ(guard_clear_by_path(&handle, &dimm0, 0),
+              GUARD_STATUS_CANNOT_DELETE);
+    EXPECT_EQ(guard_get_entity_path("/sys-0/node-9/dimm-0", &dimm0),
+              GUARD_STATUS_INVALID_ENTITY_PATH);
+    EXPECT_STREQ(guard_status_str(GUARD_STATUS_CANNOT_DELETE),
+                 "Cannot delete a non-core system generated guard record");
+    EXPECT_EQ(guard_close(&handle), GUARD_STATUS_OK);
+    EXPECT_EQ(guard_close(&handle), GUARD_STATUS_INVALID_ARGUMENT);
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "libguard/guard_crc.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using openpower::guard::crc32c;
+using openpower::guard::crc32cPortable;
+
+TEST(TestCrc32c, KnownValues)
+{
+    // Check values from RFC 3720 (iSCSI), appendix B.4
+    const char digits[] = "123456789";
+    EXPECT_EQ(crc32c(digits, strlen(digits)), 0xE3069283);
+    EXPECT_EQ(crc32cPortable(digits, strlen(digits)), 0xE3069283);
+
+    std::vector<uint8_t> zeros(32, 0x00);
+    EXPECT_EQ(crc32c(zeros.data(), zeros.size()), 0x8A9136AA);
+    std::vector<uint8_t> ones(32, 0xFF);
+    EXPECT_EQ(crc32c(ones.data(), ones.size()), 0x62A8AB43);
+
+    EXPECT_EQ(crc32c(nullptr, 0), 0);
+}
+
+TEST(TestCrc32c, SameAsPortable)
+{
+    std::vector<uint8_t> buf(1024 + 8);
+    for (size_t i = 0; i < buf.size(); i++)
+    {
+        buf[i] = static_cast<uint8_t>((i * 131) ^ (i >> 3));
+    }
+
+    // Every alignment and length up to a few guard records
+    for (size_t offset = 0; offset < 8; offset++)
+    {
+        for (size_t size = 0; size <= 300; size++)
+        {
+            EXPECT_EQ(crc32c(buf.data() + offset, size),
+                      crc32cPortable(buf.data() + offset, size))
+                << "offset " << offset << " size " << size;
+        }
+    }
+}
+
+TEST(TestCrc32c, Continue)
+{
+    const char digits[] = "123456789";
+    uint32_t crc = crc32c(digits, 4);
+    EXPECT_EQ(crc32c(digits + 4, 5, crc), 0xE3069283);
+    crc = crc32cPortable(digits, 3);
+    EXPECT_EQ(crc32cPortable(digits + 3, 6, crc), 0xE3069283);
+}
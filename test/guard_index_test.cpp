@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_test_fixture.hpp"
+#include "libguard/guard_entity.hpp"
+#include "libguard/guard_index.hpp"
+#include "libguard/guard_interface.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace guard = openpower::guard;
+
+class TestGuardIndex : public InitializedGuardFileTest
+{
+};
+
+TEST_F(TestGuardIndex, SameAsGetAll)
+{
+    guard::EntityPath proc = *guard::getEntityPath("/sys-0/node-0/proc-1");
+    guard::create(dimm(0), 0x90000001, guard::GARD_Predictive);
+    guard::create(dimm(1));
+    guard::create(proc, 0x90000002, guard::GARD_Fatal);
+    guard::create(dimm(2), 0, guard::GARD_Reconfig);
+    guard::clear(dimm(1));
+
+    guard::GuardIndex index;
+    guard::GuardRecords records = guard::getAll();
+    ASSERT_EQ(index.size(), records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        EXPECT_EQ(index.recordIds()[i], records[i].recordId);
+        EXPECT_EQ(index.errTypes()[i], records[i].errType);
+        EXPECT_EQ(index.targetTypes()[i],
+                  guard::getTargetType(records[i].targetId));
+        EXPECT_EQ(index.pathHashes()[i],
+                  guard::GuardIndex::hash(records[i].targetId));
+        EXPECT_EQ(index.get(i).recordId, records[i].recordId);
+        EXPECT_EQ(index.get(i).targetId, records[i].targetId);
+    }
+
+    EXPECT_EQ(index.countUnresolved(), 3);
+    EXPECT_EQ(index.countUnresolved(true), 2);
+    EXPECT_EQ(index.filterByType(guard::GARD_Fatal),
+              std::vector<size_t>{2});
+    EXPECT_EQ(index.filterByTarget(ENUM_ATTR_TYPE_DIMM),
+              (std::vector<size_t>{0, 3}));
+    EXPECT_EQ(index.filterByTarget(ENUM_ATTR_TYPE_PROC),
+              std::vector<size_t>{2});
+}
+
+TEST_F(TestGuardIndex, Find)
+{
+    guard::create(dimm(0));
+    guard::create(dimm(1));
+    guard::clear(dimm(0));
+    guard::create(dimm(0));
+
+    // The resolved record of the same target is skipped
+    guard::GuardIndex index;
+    ASSERT_EQ(index.size(), 3);
+    EXPECT_EQ(index.find(dimm(0)), 2);
+    EXPECT_EQ(index.find(dimm(1)), 1);
+    EXPECT_EQ(index.find(dimm(2)), -1);
+    EXPECT_EQ(index.find(index.recordIds()[1]), 1);
+    EXPECT_EQ(index.find(uint32_t(100)), -1);
+    EXPECT_EQ(index.find(uint32_t(GUARD_RESOLVED)), -1);
+
+    // Entity path with more elements than it can hold is never equal
+    guard::EntityPath invalid = dimm(0);
+    invalid.type_size = (invalid.type_size & 0xF0) | 0x0B;
+    EXPECT_EQ(guard::GuardIndex::hash(invalid), 0);
+    EXPECT_EQ(index.find(invalid), -1);
+
+    // Snapshot until refreshed
+    guard::clear(dimm(1));
+    EXPECT_EQ(index.find(dimm(1)), 1);
+    index.refresh();
+    EXPECT_EQ(index.find(dimm(1)), -1);
+    EXPECT_EQ(index.countUnresolved(), 1);
+    EXPECT_EQ(index.find(dimm(0)), 2);
+}
@@ -1,54 +1,27 @@
 // SPDX-License-Identifier: Apache-2.0
+#include "config.h"
+
+#include "guard_test_fixture.hpp"
 #include "libguard/guard_common.hpp"
+#include "libguard/guard_crc.hpp"
 #include "libguard/guard_entity.hpp"
 #include "libguard/guard_exception.hpp"
 #include "libguard/guard_file.hpp"
 #include "libguard/guard_interface.hpp"
+#include "libguard/guard_stats.hpp"
 #include "libguard/include/guard_record.hpp"
 
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <memory_resource>
 
 #include <gtest/gtest.h>
 
 namespace fs = std::filesystem;
 
-class TestGuardRecord : public ::testing::Test
+class TestGuardRecord : public GuardFileTest
 {
-  public:
-    TestGuardRecord()
-    {
-    }
-
-    void SetUp() override
-    {
-        char dirTemplate[] = "/tmp/FakeGuard.XXXXXX";
-        auto dirPtr = mkdtemp(dirTemplate);
-        if (dirPtr == NULL)
-        {
-            throw std::bad_alloc();
-        }
-        guardDir = std::string(dirPtr);
-        fs::create_directories(guardDir);
-        guardFile = guardDir;
-        guardFile /= "GUARD";
-
-        //! create a guard file
-        std::ofstream file(guardFile, std::ios::out | std::ios::binary);
-        static char buf[656];
-        memset(buf, ~0, sizeof(buf));
-        file.write(reinterpret_cast<const char*>(buf), 656);
-        //! set guard file to use
-        openpower::guard::utest::setGuardFile(guardFile);
-    }
-    void TearDown() override
-    {
-        fs::remove_all(guardDir);
-    }
-
-  protected:
-    fs::path guardFile;
-    std::string guardDir;
 };
 
 TEST_F(TestGuardRecord, CreateGuardRecord)
@@ -124,6 +97,84 @@ TEST_F(TestGuardRecord, NegTestCaseEP)
     EXPECT_EQ(entityPath, std::nullopt);
 }
 
+TEST_F(TestGuardRecord, GetEntityPathFromStringView)
+{
+    openpower::guard::libguard_init();
+    std::string phyPath = "/sys-0/node-0/proc-1/eq-0/fc-0/core-0";
+    std::string_view phyPathView{phyPath};
+    std::optional<openpower::guard::EntityPath> entityPath =
+        openpower::guard::getEntityPath(phyPathView);
+    EXPECT_NE(entityPath, std::nullopt);
+    EXPECT_EQ(entityPath, openpower::guard::getEntityPath(phyPath));
+
+    // A view over a larger buffer must only consider the viewed characters
+    std::string_view prefixView{phyPathView.data(), phyPathView.size() - 2};
+    EXPECT_EQ(openpower::guard::getEntityPath(prefixView), std::nullopt);
+}
+
+TEST_F(TestGuardRecord, ResolvePhysicalPaths)
+{
+    openpower::guard::libguard_init();
+    std::vector<std::string> phyPaths = {
+        "/sys-0/node-0/proc-1/eq-0/fc-0/core-0", "/sys-0/node-0/dimm-1",
+        "/sys-0/node-0/proc-1/eq-0/fc-0/core-0"};
+    std::vector<openpower::guard::EntityPath> entityPaths;
+    for (const auto& phyPath : phyPaths)
+    {
+        entityPaths.push_back(*openpower::guard::getEntityPath(phyPath));
+    }
+    // Entity path which is not present in the list
+    entityPaths.push_back({0x21, 0x01, 0x07});
+
+    auto resolvedPaths = openpower::guard::resolvePhysicalPaths(entityPaths);
+    EXPECT_EQ(resolvedPaths.size(), entityPaths.size());
+    for (size_t i = 0; i < phyPaths.size(); i++)
+    {
+        EXPECT_EQ(resolvedPaths[i], phyPaths[i]);
+        EXPECT_EQ(resolvedPaths[i],
+                  openpower::guard::getPhysicalPath(entityPaths[i]));
+    }
+    EXPECT_EQ(resolvedPaths.back(), std::nullopt);
+}
+
+#ifndef PGUARD
+TEST_F(TestGuardRecord, GetBySerialNumber)
+{
+    openpower::guard::libguard_init();
+    std::optional<openpower::guard::EntityPath> entityPath =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-0");
+    openpower::guard::create(*entityPath);
+    entityPath = openpower::guard::getEntityPath("/sys-0/node-0/dimm-1");
+    openpower::guard::GuardRecord record =
+        openpower::guard::create(*entityPath);
+
+    // Update the FRU serial number of the second record directly in the
+    // file, since the FRU VPD is only available with device tree.
+    std::string serialNum{"YA3000000001"};
+    openpower::guard::GuardFile file(guardFile);
+    size_t headerSize = 16;
+    size_t serialNumPos = headerSize + sizeof(record) +
+                          offsetof(openpower::guard::GuardRecord, u);
+    file.write(serialNumPos, serialNum.data(), serialNum.size());
+#ifdef GUARD_RECORD_CRC
+    // Drop the checksum, which is not valid after the direct write
+    openpower::guard::GuardRecordCrc noCrc;
+    memset(&noCrc, 0xff, sizeof(noCrc));
+    file.write(headerSize + 2 * sizeof(record) - sizeof(noCrc), &noCrc,
+               sizeof(noCrc));
+#endif
+
+    openpower::guard::GuardRecords records =
+        openpower::guard::getBySerialNumber(serialNum);
+    EXPECT_EQ(records.size(), 1);
+    EXPECT_EQ(records.at(0).recordId, record.recordId);
+    EXPECT_EQ(records.at(0).targetId, entityPath);
+
+    EXPECT_EQ(openpower::guard::getBySerialNumber("YA3000000002").size(), 0);
+    EXPECT_EQ(openpower::guard::getBySerialNumber("").size(), 0);
+}
+#endif
+
 TEST_F(TestGuardRecord, NegTestCaseFullGuardFile)
 {
     openpower::guard::libguard_init();
@@ -322,3 +373,343 @@ TEST_F(TestGuardRecord, ClearResolvedGuardRecord)
     openpower::guard::GuardRecords records = openpower::guard::getAll();
     EXPECT_EQ(records.size(), 4);
 }
+
+TEST_F(TestGuardRecord, GetStats)
+{
+    openpower::guard::libguard_init();
+    openpower::guard::resetStats();
+    std::string phyPath = "/sys-0/node-0/dimm-0";
+    std::optional<openpower::guard::EntityPath> entityPath =
+        openpower::guard::getEntityPath(phyPath);
+    openpower::guard::create(*entityPath);
+    openpower::guard::getAll();
+    openpower::guard::clear(*entityPath);
+
+    auto guardStats = openpower::guard::getStats();
+    EXPECT_GT(guardStats.opens, 0);
+    EXPECT_GT(guardStats.reads, 0);
+#if defined(GUARD_HEADER_EXT) && !defined(PGUARD)
+    // The header extension is written along with the records
+    EXPECT_EQ(guardStats.writes, 4);
+    EXPECT_EQ(guardStats.bytesWritten,
+              2 * (sizeof(openpower::guard::GuardRecord) +
+                   sizeof(openpower::guard::GuardHeaderExt)));
+#else
+    EXPECT_EQ(guardStats.writes, 2);
+    EXPECT_EQ(guardStats.bytesWritten,
+              2 * sizeof(openpower::guard::GuardRecord));
+    EXPECT_EQ(guardStats.bytesRead, guardStats.recordsScanned *
+                                        sizeof(openpower::guard::GuardRecord));
+#endif
+    using Api = openpower::guard::stats::Api;
+    for (auto api : {Api::Create, Api::GetAll, Api::Clear})
+    {
+        const auto& latency = guardStats.latency[static_cast<size_t>(api)];
+        EXPECT_EQ(latency.count, 1);
+        EXPECT_GE(latency.totalNs, latency.maxNs);
+    }
+    EXPECT_EQ(
+        guardStats.latency[static_cast<size_t>(Api::InvalidateAll)].count, 0);
+
+    openpower::guard::resetStats();
+    EXPECT_EQ(openpower::guard::getStats().opens, 0);
+}
+
+TEST_F(TestGuardRecord, ErrorCodeVariants)
+{
+    openpower::guard::libguard_init();
+    std::error_code ec;
+    std::optional<openpower::guard::EntityPath> entityPath =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-0");
+    openpower::guard::GuardRecord record = openpower::guard::create(
+        *entityPath, 0x10, openpower::guard::GARD_Predictive, false, ec);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(record.recordId, 1);
+
+    openpower::guard::create(*entityPath, 0x10,
+                             openpower::guard::GARD_Predictive, false, ec);
+    EXPECT_EQ(ec, openpower::guard::GuardError::AlreadyGuarded);
+
+    // System generated guard record can not be cleared without force
+    openpower::guard::clear(*entityPath, false, ec);
+    EXPECT_EQ(ec, openpower::guard::GuardError::CannotDelete);
+    openpower::guard::clear(*entityPath, true, ec);
+    EXPECT_FALSE(ec);
+    openpower::guard::clear(0x20, true, ec);
+    EXPECT_EQ(ec, openpower::guard::GuardError::InvalidEntityPath);
+
+    openpower::guard::GuardRecords records =
+        openpower::guard::getAll(false, ec);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(records.size(), 1);
+
+    // The exception API reports the same errors
+    EXPECT_THROW(openpower::guard::clear(0x20),
+                 openpower::guard::exception::InvalidEntityPath);
+
+    openpower::guard::utest::setGuardFile(guardDir + "/NotExist");
+    records = openpower::guard::getAll(false, ec);
+    EXPECT_EQ(ec, openpower::guard::GuardError::GuardFileOpenFailed);
+    EXPECT_TRUE(records.empty());
+    EXPECT_THROW(openpower::guard::getAll(),
+                 openpower::guard::exception::GuardFileOpenFailed);
+}
+
+TEST_F(TestGuardRecord, ExceptionMessage)
+{
+    openpower::guard::libguard_init();
+    std::optional<openpower::guard::EntityPath> entityPath =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-0");
+
+    // The exception of the failure is thrown as is, not rebuilt from the
+    // error code with the generic message
+    openpower::guard::utest::setGuardFile(guardDir + "/NotExist");
+    std::error_code ec;
+    openpower::guard::getAll(false, ec);
+    for (auto operation : {std::function<void()>(
+                               [] { openpower::guard::getAll(); }),
+                           std::function<void()>([&] {
+                               openpower::guard::create(*entityPath);
+                           }),
+                           std::function<void()>([&] {
+                               openpower::guard::clear(*entityPath);
+                           })})
+    {
+        try
+        {
+            operation();
+            ADD_FAILURE() << "GuardFileOpenFailed is not thrown";
+        }
+        catch (const openpower::guard::exception::GuardFileOpenFailed& ex)
+        {
+            EXPECT_STREQ(ex.what(),
+                         "Exception thrown as failed to open the guard file");
+            EXPECT_NE(ex.what(), ec.message());
+        }
+    }
+}
+
+#if defined(GUARD_HEADER_EXT) && !defined(PGUARD)
+TEST_F(TestGuardRecord, HeaderExtension)
+{
+    openpower::guard::libguard_init();
+    std::optional<openpower::guard::EntityPath> dimm0 =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-0");
+    std::optional<openpower::guard::EntityPath> dimm1 =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-1");
+    openpower::guard::create(*dimm0);
+    openpower::guard::create(*dimm1);
+    openpower::guard::clear(*dimm1);
+
+    openpower::guard::GuardHeaderExt ext;
+    openpower::guard::GuardFile file(guardFile);
+    file.read(9, &ext, sizeof(ext));
+    EXPECT_EQ(ext.revision, openpower::guard::GUARD_HEADER_EXT_REVISION);
+    EXPECT_EQ(be16toh(ext.usedSlots), 2);
+    EXPECT_EQ(be16toh(ext.resolvedSlots), 1);
+    EXPECT_EQ(be16toh(ext.nextRecordId), 3);
+
+    // The record id of the resolved record is not reused
+    openpower::guard::GuardRecord record = openpower::guard::create(*dimm1);
+    EXPECT_EQ(record.recordId, 3);
+    EXPECT_EQ(openpower::guard::getAll().size(), 3);
+
+    // Record appended by Hostboot, without updating the header extension
+    record.recordId = htobe32(7);
+    record.targetId = *openpower::guard::getEntityPath("/sys-0/node-0/dimm-2");
+    memset(record.padding, 0xff, sizeof(record.padding));
+    file.write(16 + 3 * sizeof(record), &record, sizeof(record));
+    openpower::guard::GuardRecords records = openpower::guard::getAll();
+    ASSERT_EQ(records.size(), 4);
+    EXPECT_EQ(records[3].recordId, 7);
+
+    // Resolving recomputes the header extension from the records
+    openpower::guard::clear(record.targetId);
+    file.read(9, &ext, sizeof(ext));
+    EXPECT_EQ(ext.revision, openpower::guard::GUARD_HEADER_EXT_REVISION);
+    EXPECT_EQ(be16toh(ext.usedSlots), 4);
+    EXPECT_EQ(be16toh(ext.resolvedSlots), 2);
+    EXPECT_EQ(be16toh(ext.nextRecordId), 8);
+}
+#endif
+
+#if defined(GUARD_RECORD_CRC) && !defined(PGUARD)
+TEST_F(TestGuardRecord, RecordChecksum)
+{
+    openpower::guard::libguard_init();
+    std::optional<openpower::guard::EntityPath> dimm0 =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-0");
+    std::optional<openpower::guard::EntityPath> dimm1 =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-1");
+    openpower::guard::create(*dimm0);
+    openpower::guard::create(*dimm1);
+
+    openpower::guard::GuardRecord record;
+    openpower::guard::GuardRecordCrc recordCrc;
+    openpower::guard::GuardFile file(guardFile);
+    file.read(16, &record, sizeof(record));
+    memcpy(&recordCrc, record.padding + sizeof(record.padding) -
+                           sizeof(recordCrc),
+           sizeof(recordCrc));
+    EXPECT_EQ(recordCrc.marker, openpower::guard::GUARD_RECORD_CRC_MARKER);
+
+    // Flipped bit in the first record
+    record.elogId ^= htobe32(0x10);
+    file.write(16, &record, sizeof(record));
+    openpower::guard::resetStats();
+    openpower::guard::GuardRecords records = openpower::guard::getAll();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].targetId, *dimm1);
+    EXPECT_EQ(openpower::guard::getStats().checksumErrors, 1);
+
+    // Records without the checksum e.g. written by Hostboot are not checked
+    memset(record.padding, 0xff, sizeof(record.padding));
+    file.write(16, &record, sizeof(record));
+    EXPECT_EQ(openpower::guard::getAll().size(), 2);
+
+    // Resolving updates the checksum
+    openpower::guard::clear(*dimm1);
+    file.read(16 + sizeof(record), &record, sizeof(record));
+    memcpy(&recordCrc, record.padding + sizeof(record.padding) -
+                           sizeof(recordCrc),
+           sizeof(recordCrc));
+    EXPECT_EQ(be32toh(recordCrc.crc),
+              openpower::guard::crc32c(&record, sizeof(record) -
+                                                    sizeof(recordCrc.crc)));
+}
+#endif
+
+TEST_F(TestGuardRecord, PGuardLayout)
+{
+    // Record written by Hostboot in the PGUARD layout, 37 bytes slots
+    // without the header
+    uint8_t slot[37];
+    memset(slot, 0xff, sizeof(slot));
+    openpower::guard::GuardRecord record;
+    record.recordId = htobe32(1);
+    record.targetId = *openpower::guard::getEntityPath("/sys-0/node-0/dimm-0");
+    record.elogId = htobe32(0x90000001);
+    record.errType = openpower::guard::GARD_Predictive;
+    memcpy(slot, &record, offsetof(openpower::guard::GuardRecord, errType) +
+                              sizeof(record.errType));
+    {
+        openpower::guard::GuardFile file(guardFile);
+        file.write(0, slot, sizeof(slot));
+    }
+
+    openpower::guard::libguard_init();
+    EXPECT_EQ(openpower::guard::getGuardLayout(),
+              openpower::guard::GuardLayout::PGuard);
+    std::optional<openpower::guard::EntityPath> dimm1 =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-1");
+    EXPECT_EQ(openpower::guard::create(*dimm1).recordId, 2);
+    openpower::guard::GuardRecords records = openpower::guard::getAll();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].elogId, 0x90000001);
+    EXPECT_EQ(records[0].errType, openpower::guard::GARD_Predictive);
+    EXPECT_EQ(records[1].targetId, *dimm1);
+
+    // The new record is in the next slot and, the header is not added
+    openpower::guard::GuardFile file(guardFile);
+    uint8_t next[sizeof(slot)];
+    uint32_t recordId;
+    file.read(sizeof(slot), &recordId, sizeof(recordId));
+    EXPECT_EQ(be32toh(recordId), 2);
+    file.read(0, next, sizeof(next));
+    EXPECT_EQ(memcmp(next, slot, sizeof(slot)), 0);
+
+    openpower::guard::clear(*dimm1);
+    EXPECT_EQ(openpower::guard::getAll()[1].recordId, GUARD_RESOLVED);
+}
+
+#ifndef PGUARD
+TEST_F(TestGuardRecord, PGuardLayoutReusedSlot)
+{
+    // Full partition with a resolved record with the resource recovery
+    // flag and a live record, written by Hostboot in the PGUARD layout
+    uint8_t slots[2][37];
+    memset(slots, 0x00, sizeof(slots));
+    openpower::guard::GuardRecord record;
+    record.recordId = GUARD_RESOLVED;
+    record.targetId = *openpower::guard::getEntityPath("/sys-0/node-0/dimm-0");
+    record.elogId = htobe32(0x90000001);
+    record.errType = openpower::guard::GARD_Predictive;
+    size_t fieldsSize =
+        offsetof(openpower::guard::GuardRecord, errType) + sizeof(uint8_t);
+    memcpy(slots[0], &record, fieldsSize);
+    slots[0][fieldsSize] = 0x01;
+    record.recordId = htobe32(2);
+    record.targetId = *openpower::guard::getEntityPath("/sys-0/node-0/dimm-1");
+    memcpy(slots[1], &record, fieldsSize);
+    createFile(guardFile, sizeof(slots));
+    {
+        openpower::guard::GuardFile file(guardFile);
+        file.write(0, slots, sizeof(slots));
+    }
+
+    openpower::guard::libguard_init();
+    ASSERT_EQ(openpower::guard::getGuardLayout(),
+              openpower::guard::GuardLayout::PGuard);
+    std::optional<openpower::guard::EntityPath> dimm3 =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-3");
+    openpower::guard::create(*dimm3);
+
+    // The new record is in the resolved slot, without the fields of the
+    // previous record after the type
+    uint8_t slot[37];
+    openpower::guard::GuardFile file(guardFile);
+    file.read(0, slot, sizeof(slot));
+    memcpy(&record, slot, fieldsSize);
+    EXPECT_EQ(record.targetId, *dimm3);
+    EXPECT_EQ(record.errType, openpower::guard::GARD_User_Manual);
+    for (size_t i = fieldsSize; i < sizeof(slot); i++)
+    {
+        EXPECT_EQ(slot[i], 0xff) << "offset " << i;
+    }
+    file.read(sizeof(slot), slot, sizeof(slot));
+    EXPECT_EQ(memcmp(slot, slots[1], sizeof(slot)), 0);
+}
+#endif
+
+TEST_F(TestGuardRecord, GetAllSummaries)
+{
+    openpower::guard::libguard_init();
+    std::optional<openpower::guard::EntityPath> dimm0 =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-0");
+    std::optional<openpower::guard::EntityPath> dimm1 =
+        openpower::guard::getEntityPath("/sys-0/node-0/dimm-1");
+    openpower::guard::create(*dimm0, 0x90000001,
+                             openpower::guard::GARD_Predictive);
+    openpower::guard::create(*dimm1, 0, openpower::guard::GARD_Reconfig);
+    openpower::guard::clear(*dimm0, true);
+
+    // The summaries are allocated from the arena
+    uint8_t buf[1024];
+    std::pmr::monotonic_buffer_resource arena(
+        buf, sizeof(buf), std::pmr::null_memory_resource());
+    openpower::guard::resetStats();
+    openpower::guard::GuardRecordSummaries summaries =
+        openpower::guard::getAllSummaries(false, &arena);
+    EXPECT_EQ(summaries.get_allocator().resource(), &arena);
+
+    // Timed apart from getAll()
+    using Api = openpower::guard::stats::Api;
+    auto guardStats = openpower::guard::getStats();
+    EXPECT_EQ(
+        guardStats.latency[static_cast<size_t>(Api::GetAllSummaries)].count,
+        1);
+    EXPECT_EQ(guardStats.latency[static_cast<size_t>(Api::GetAll)].count, 0);
+    openpower::guard::GuardRecords records = openpower::guard::getAll();
+    ASSERT_EQ(summaries.size(), records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        EXPECT_EQ(summaries[i].recordId, records[i].recordId);
+        EXPECT_EQ(summaries[i].elogId, records[i].elogId);
+        EXPECT_EQ(summaries[i].targetId, records[i].targetId);
+        EXPECT_EQ(summaries[i].errType, records[i].errType);
+    }
+    EXPECT_EQ(summaries[0].recordId, GUARD_RESOLVED);
+    EXPECT_EQ(summaries[0].elogId, 0x90000001);
+
+    EXPECT_EQ(openpower::guard::getAllSummaries(true).size(), 1);
+}
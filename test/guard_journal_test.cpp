@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_test_fixture.hpp"
+#include "libguard/guard_entity.hpp"
+#include "libguard/guard_exception.hpp"
+#include "libguard/guard_interface.hpp"
+#include "libguard/guard_journal.hpp"
+#include "libguard/guard_stats.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace guard = openpower::guard;
+
+class TestJournaledGuard : public InitializedGuardFileTest
+{
+  public:
+    void SetUp() override
+    {
+        InitializedGuardFileTest::SetUp();
+        journalFile = guardDir + "/GUARD.journal";
+    }
+
+    /**
+     * @brief Return the content of the file
+     */
+    static std::vector<char> readFile(const fs::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+    }
+
+    /**
+     * @brief Write the content to the file
+     */
+    static void writeFile(const fs::path& path, const std::vector<char>& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size());
+    }
+
+  protected:
+    fs::path journalFile;
+};
+
+TEST_F(TestJournaledGuard, Checkpoint)
+{
+    auto initial = readFile(guardFile);
+    guard::JournaledGuard journaled(journalFile);
+    EXPECT_EQ(journaled.create(dimm(0)).recordId, 1);
+    EXPECT_EQ(journaled.create(dimm(1)).recordId, 2);
+    journaled.clear(dimm(1));
+    EXPECT_THROW(journaled.clear(dimm(2)), guard::exception::InvalidEntityPath);
+    EXPECT_EQ(journaled.pending(), 3);
+
+    // The guard file is not changed until the checkpoint
+    EXPECT_EQ(readFile(guardFile), initial);
+    guard::GuardRecords records = journaled.getAll();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].targetId, dimm(0));
+    EXPECT_EQ(records[1].recordId, GUARD_RESOLVED);
+
+    journaled.checkpoint();
+    EXPECT_EQ(journaled.pending(), 0);
+    EXPECT_EQ(fs::file_size(journalFile), sizeof(guard::GuardJournalHeader));
+    records = guard::getAll();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].targetId, dimm(0));
+    EXPECT_EQ(records[0].recordId, 1);
+    EXPECT_EQ(records[1].recordId, GUARD_RESOLVED);
+}
+
+TEST_F(TestJournaledGuard, Replay)
+{
+    auto initial = readFile(guardFile);
+    std::vector<char> journal;
+    {
+        guard::JournaledGuard journaled(journalFile);
+        journaled.create(dimm(0));
+        journaled.create(dimm(1));
+        // Journal as left by a crash before the checkpoint
+        journal = readFile(journalFile);
+    }
+    writeFile(guardFile, initial);
+
+    // Torn entry at the end is dropped
+    std::vector<char> torn(journal);
+    torn.insert(torn.end(), {0x00, 0x00, 0x00, 0x20, 0x01});
+    writeFile(journalFile, torn);
+    {
+        guard::JournaledGuard journaled(journalFile);
+        EXPECT_EQ(journaled.pending(), 2);
+        EXPECT_EQ(fs::file_size(journalFile), journal.size());
+        EXPECT_EQ(journaled.getAll().size(), 2);
+        EXPECT_EQ(readFile(guardFile), initial);
+    }
+    EXPECT_EQ(guard::getAll().size(), 2);
+
+    // Journal is discarded if the guard file is changed after it, e.g. by
+    // Hostboot
+    writeFile(guardFile, initial);
+    writeFile(journalFile, journal);
+    guard::create(dimm(3));
+    guard::resetStats();
+    {
+        guard::JournaledGuard journaled(journalFile);
+        EXPECT_EQ(journaled.pending(), 0);
+        EXPECT_EQ(guard::getStats().journalDrops, 2);
+        EXPECT_EQ(fs::file_size(journalFile),
+                  sizeof(guard::GuardJournalHeader));
+        guard::GuardRecords records = journaled.getAll();
+        ASSERT_EQ(records.size(), 1);
+        EXPECT_EQ(records[0].targetId, dimm(3));
+    }
+    guard::GuardRecords records = guard::getAll();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].targetId, dimm(3));
+
+    // Interrupted checkpoint is completed on open
+    writeFile(guardFile, initial);
+    guard::create(dimm(0));
+    journal[offsetof(guard::GuardJournalHeader, state)] =
+        guard::GUARD_JOURNAL_CHECKPOINTING;
+    writeFile(journalFile, journal);
+    {
+        guard::JournaledGuard journaled(journalFile);
+        EXPECT_EQ(journaled.pending(), 0);
+    }
+    records = guard::getAll();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].targetId, dimm(0));
+    EXPECT_EQ(records[1].targetId, dimm(1));
+}
+
+TEST_F(TestJournaledGuard, CheckpointTriggers)
+{
+    // Journal is full after the first entry
+    {
+        guard::JournaledGuard journaled(journalFile, 1);
+        journaled.create(dimm(0));
+        EXPECT_EQ(journaled.pending(), 0);
+        EXPECT_EQ(guard::getAll().size(), 1);
+    }
+
+    guard::JournaledGuard journaled(journalFile, 4096,
+                                    std::chrono::milliseconds(10));
+    journaled.create(dimm(1));
+    for (int i = 0; (i < 500) && (journaled.pending() > 0); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(journaled.pending(), 0);
+    EXPECT_EQ(guard::getAll().size(), 2);
+}
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "libguard/guard_log.hpp"
+#include "libguard/guard_log_sink.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace log = openpower::guard::log;
+
+/**
+ * @class CaptureLogSink
+ *
+ * Sink to capture the traces, it can be blocked to emulate a slow console.
+ */
+class CaptureLogSink : public log::LogSink
+{
+  public:
+    void write(int /*level*/, const char* fmt, va_list ap) override
+    {
+        char buf[512];
+        vsnprintf(buf, sizeof(buf), fmt, ap);
+        std::unique_lock<std::mutex> lock(mutex);
+        unblocked.wait(lock, [this] { return !blocked; });
+        lines.emplace_back(buf);
+    }
+
+    void block(bool block)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            blocked = block;
+        }
+        unblocked.notify_all();
+    }
+
+    std::vector<std::string> getLines()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return lines;
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable unblocked;
+    bool blocked = false;
+    std::vector<std::string> lines;
+};
+
+class TestGuardLog : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        capture = std::make_shared<CaptureLogSink>();
+    }
+
+    void TearDown() override
+    {
+        log::setLogSink(nullptr);
+    }
+
+  protected:
+    std::shared_ptr<CaptureLogSink> capture;
+};
+
+TEST_F(TestGuardLog, SetLogSink)
+{
+    log::setLogSink(capture);
+    GUARD_LOG(GUARD_ERROR, "Record %d of %s", 1, "GUARD");
+    log::setLogSink(nullptr);
+    GUARD_LOG(GUARD_ERROR, "Not captured");
+
+    auto lines = capture->getLines();
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines[0], "Record 1 of GUARD");
+}
+
+TEST_F(TestGuardLog, AsyncTextSink)
+{
+    auto sink = std::make_shared<log::AsyncLogSink>(capture, 64);
+    log::setLogSink(sink);
+    for (int i = 0; i < 32; i++)
+    {
+        GUARD_LOG(GUARD_ERROR, "Trace %d", i);
+    }
+    sink->flush();
+
+    auto lines = capture->getLines();
+    ASSERT_EQ(lines.size(), 32);
+    for (int i = 0; i < 32; i++)
+    {
+        EXPECT_EQ(lines[i], "Trace " + std::to_string(i));
+    }
+}
+
+TEST_F(TestGuardLog, AsyncBinarySink)
+{
+    auto sink = std::make_shared<log::AsyncLogSink>(
+        capture, 64, log::AsyncLogSink::Format::Binary);
+    log::setLogSink(sink);
+
+    std::string name = "/sys-0/node-0/dimm-0";
+    GUARD_LOG(GUARD_ERROR, "Path %s id 0x%08x size %zu %lld%% %.2f %c",
+              name.c_str(), 0xABCDu, static_cast<size_t>(128), -5LL, 1.5, 'x');
+    // The string argument is copied while logging
+    name = "changed";
+    // More arguments than the binary record holds are formatted as text
+    GUARD_LOG(GUARD_ERROR, "%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8,
+              9);
+    GUARD_LOG(GUARD_ERROR, "Width %*d", 4, 7);
+    sink->flush();
+
+    auto lines = capture->getLines();
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(lines[0],
+              "Path /sys-0/node-0/dimm-0 id 0x0000abcd size 128 -5% 1.50 x");
+    EXPECT_EQ(lines[1], "1 2 3 4 5 6 7 8 9");
+    EXPECT_EQ(lines[2], "Width    7");
+}
+
+TEST_F(TestGuardLog, AsyncSinkOverflowNeverBlocks)
+{
+    auto sink = std::make_shared<log::AsyncLogSink>(capture, 8);
+    log::setLogSink(sink);
+
+    // The target sink is blocked so, the ring buffer gets full
+    capture->block(true);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++)
+    {
+        GUARD_LOG(GUARD_ERROR, "Trace %d", i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+    EXPECT_GT(sink->dropped(), 0);
+
+    capture->block(false);
+    sink->flush();
+    auto lines = capture->getLines();
+    EXPECT_EQ(lines.size() + sink->dropped(), 1000 + 1 /* Dropped trace */);
+    EXPECT_NE(lines.back().find("traces are dropped"), std::string::npos);
+}
+
+TEST_F(TestGuardLog, AsyncSinkMultipleThreads)
+{
+    auto sink = std::make_shared<log::AsyncLogSink>(capture, 4096);
+    log::setLogSink(sink);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 256; i++)
+            {
+                GUARD_LOG(GUARD_ERROR, "Thread %d trace %d", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    sink->flush();
+    EXPECT_EQ(capture->getLines().size(), 4 * 256);
+}
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guard_test_fixture.hpp"
+#include "libguard/guard_entity.hpp"
+#include "libguard/guard_exception.hpp"
+#include "libguard/guard_interface.hpp"
+#include "libguard/guard_migrate.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace guard = openpower::guard;
+
+class TestGuardMigrate : public InitializedGuardFileTest
+{
+  public:
+    /**
+     * @brief Return the guard records, resolved ones included, of the file
+     */
+    static guard::GuardRecords getAll(const fs::path& path)
+    {
+        guard::utest::setGuardFile(path);
+        guard::libguard_init();
+        return guard::getAll();
+    }
+
+    /**
+     * @brief Check the fields which are kept in both the layouts
+     */
+    static void expectSameRecords(const guard::GuardRecords& records,
+                                  const guard::GuardRecords& expected)
+    {
+        ASSERT_EQ(records.size(), expected.size());
+        for (size_t i = 0; i < records.size(); i++)
+        {
+            EXPECT_EQ(records[i].recordId, expected[i].recordId);
+            EXPECT_EQ(records[i].targetId, expected[i].targetId);
+            EXPECT_EQ(records[i].elogId, expected[i].elogId);
+            EXPECT_EQ(records[i].errType, expected[i].errType);
+        }
+    }
+};
+
+TEST_F(TestGuardMigrate, ConvertLayout)
+{
+    guard::create(dimm(0), 0x90000001, guard::GARD_Predictive);
+    guard::create(dimm(1), 0x90000002, guard::GARD_Fatal);
+    guard::create(dimm(2));
+    guard::clear(dimm(1), true);
+    guard::GuardRecords records = guard::getAll();
+
+    fs::path pguardFile = guardDir + "/GUARD.pguard";
+    createFile(pguardFile, 656);
+    EXPECT_EQ(guard::migrate(guardFile, pguardFile,
+                             guard::GuardLayout::PGuard),
+              3);
+    expectSameRecords(getAll(pguardFile), records);
+    EXPECT_EQ(guard::getGuardLayout(), guard::GuardLayout::PGuard);
+
+    // Back to the standard layout, with the header of the current version
+    fs::path standardFile = guardDir + "/GUARD.standard";
+    createFile(standardFile, 656);
+    EXPECT_EQ(guard::migrate(pguardFile, standardFile,
+                             guard::GuardLayout::Standard),
+              3);
+    guard::GuardRecord_t header;
+    std::ifstream file(standardFile, std::ios::binary);
+    file.read(reinterpret_cast<char*>(&header), 16);
+    EXPECT_EQ(memcmp(header.iv_magicNumber, GUARD_MAGIC, 8), 0);
+    EXPECT_EQ(header.iv_version, guard::CURRENT_GARD_VERSION_LAYOUT);
+    expectSameRecords(getAll(standardFile), records);
+    EXPECT_EQ(guard::getGuardLayout(), guard::GuardLayout::Standard);
+}
+
+TEST_F(TestGuardMigrate, DamagedHeader)
+{
+    guard::create(dimm(0), 0x90000001, guard::GARD_Predictive);
+    guard::create(dimm(1));
+    guard::GuardRecords records = guard::getAll();
+
+    // Standard layout with the magic number damaged, e.g. by a torn write
+    fs::path standardFile = guardDir + "/GUARD.standard";
+    createFile(standardFile, 656);
+    guard::migrate(guardFile, standardFile, guard::GuardLayout::Standard);
+    {
+        std::fstream file(standardFile,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        file.write("GUARDXXX", 8);
+    }
+
+    // The records are still read in the standard layout
+    fs::path pguardFile = guardDir + "/GUARD.pguard";
+    createFile(pguardFile, 656);
+    EXPECT_EQ(guard::migrate(standardFile, pguardFile,
+                             guard::GuardLayout::PGuard),
+              2);
+    expectSameRecords(getAll(pguardFile), records);
+
+    // The header is repaired on initialization
+    expectSameRecords(getAll(standardFile), records);
+    EXPECT_EQ(guard::getGuardLayout(), guard::GuardLayout::Standard);
+    guard::GuardRecord_t header;
+    std::ifstream file(standardFile, std::ios::binary);
+    file.read(reinterpret_cast<char*>(&header), 16);
+    EXPECT_EQ(memcmp(header.iv_magicNumber, GUARD_MAGIC, 8), 0);
+    EXPECT_EQ(header.iv_version, guard::CURRENT_GARD_VERSION_LAYOUT);
+}
+
+TEST_F(TestGuardMigrate, DropResolved)
+{
+    guard::create(dimm(0));
+    guard::create(dimm(1));
+    guard::create(dimm(2));
+    guard::clear(dimm(0));
+
+    // Target has two slots, with stale content after them
+    fs::path targetFile = guardDir + "/GUARD.small";
+    {
+        std::ofstream file(targetFile, std::ios::binary);
+        std::string buf(2 * 37 + 10, '\x5a');
+        file.write(buf.data(), buf.size());
+    }
+    EXPECT_THROW(guard::migrate(guardFile, targetFile,
+                                guard::GuardLayout::PGuard),
+                 guard::exception::GuardFileOverFlowed);
+    EXPECT_EQ(guard::migrate(guardFile, targetFile,
+                             guard::GuardLayout::PGuard, true),
+              2);
+    guard::GuardRecords records = getAll(targetFile);
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].targetId, dimm(1));
+    EXPECT_EQ(records[0].recordId, 2);
+    EXPECT_EQ(records[1].targetId, dimm(2));
+}
+
+TEST_F(TestGuardMigrate, InvalidTarget)
+{
+    EXPECT_THROW(guard::migrate(guardFile, guardFile,
+                                guard::GuardLayout::PGuard),
+                 guard::exception::InvalidEntry);
+    EXPECT_THROW(guard::migrate(guardFile, guardDir + "/NotExist",
+                                guard::GuardLayout::PGuard),
+                 guard::exception::GuardFileOpenFailed);
+}
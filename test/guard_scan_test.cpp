@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "libguard/guard_scan.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <endian.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace guard = openpower::guard;
+using guard::scanSlots;
+using guard::scanSlotsPortable;
+
+namespace
+{
+constexpr size_t keyPos = offsetof(guard::GuardRecord, targetId);
+
+/**
+ * @brief Return the entity path with the given number of path elements
+ */
+guard::EntityPath makePath(uint8_t elements, uint8_t instance)
+{
+    guard::EntityPath path;
+    memset(&path, 0xff, sizeof(path));
+    path.type_size = 0x10 | elements;
+    for (uint8_t i = 0; i < elements && i < path.maxPathElements; i++)
+    {
+        path.pathElements[i].targetType = 0x20 + i;
+        path.pathElements[i].instance = instance;
+    }
+    return path;
+}
+
+/**
+ * @brief Return the image of the slots with the live, resolved and
+ *        matching slots, and the blank slot at the given position
+ */
+std::vector<uint8_t> makeSlots(size_t count, size_t slotSize, size_t blankPos,
+                               const guard::EntityPath& key)
+{
+    std::vector<uint8_t> slots(count * slotSize);
+    for (size_t pos = 0; pos < count; pos++)
+    {
+        uint8_t* slot = slots.data() + pos * slotSize;
+        for (size_t i = 0; i < slotSize; i++)
+        {
+            slot[i] = static_cast<uint8_t>((pos * 31) ^ (i * 7));
+        }
+        guard::EntityPath path = key;
+        if (pos % 3 == 1)
+        {
+            // Differs only after the used path elements, still matches
+            path.pathElements[path.maxPathElements - 1].instance ^= 0x1;
+        }
+        else if (pos % 3 == 2)
+        {
+            path.pathElements[0].instance ^= 0x80;
+        }
+        memcpy(slot + keyPos, &path, sizeof(path));
+        uint32_t recordId = (pos % 4 == 0) ? GUARD_RESOLVED
+                                           : htobe32(pos + 1);
+        memcpy(slot, &recordId, sizeof(recordId));
+        if (pos == blankPos)
+        {
+            memset(slot, 0xff, slotSize);
+        }
+    }
+    return slots;
+}
+} // namespace
+
+TEST(TestGuardScan, SameAsPortable)
+{
+    guard::EntityPath key = makePath(3, 5);
+    // Slot sizes of the layouts, with the record bytes checked for blank
+    const size_t sizes[][2] = {{128, 128}, {128, 30}, {37, 37}, {37, 30}};
+    for (const auto& size : sizes)
+    {
+        for (size_t blankPos : {0, 1, 17, 63, 64})
+        {
+            auto slots = makeSlots(64, size[0], blankPos, key);
+            uint8_t classes[64];
+            uint8_t expected[64];
+            size_t used = scanSlotsPortable(slots.data(), 64, size[0],
+                                            size[1], &key, expected);
+            EXPECT_EQ(used, std::min<size_t>(blankPos, 64));
+            EXPECT_EQ(scanSlots(slots.data(), 64, size[0], size[1], &key,
+                                classes),
+                      used);
+            EXPECT_EQ(memcmp(classes, expected, used), 0)
+                << "slot size " << size[0] << " blank " << blankPos;
+
+            for (size_t pos = 0; pos < used; pos++)
+            {
+                uint8_t cls = (pos % 4 == 0) ? guard::SLOT_RESOLVED
+                                             : guard::SLOT_LIVE;
+                cls |= (pos % 3 != 2) ? guard::SLOT_MATCH : 0;
+                EXPECT_EQ(classes[pos], cls) << "slot " << pos;
+            }
+
+            // Without the key there is no match
+            EXPECT_EQ(scanSlots(slots.data(), 64, size[0], size[1], nullptr,
+                                classes),
+                      used);
+            for (size_t pos = 0; pos < used; pos++)
+            {
+                EXPECT_EQ(classes[pos], expected[pos] & ~guard::SLOT_MATCH);
+            }
+        }
+    }
+}
+
+TEST(TestGuardScan, OnlyTypeSize)
+{
+    // Entity path without path elements matches the same type_size, the
+    // path elements are not compared
+    guard::EntityPath key = makePath(0, 0);
+    auto slots = makeSlots(8, 128, 8, key);
+    guard::EntityPath other = makePath(1, 0);
+    memcpy(slots.data() + 128 + keyPos, &other, sizeof(other));
+    uint8_t classes[8];
+    uint8_t expected[8];
+    ASSERT_EQ(scanSlotsPortable(slots.data(), 8, 128, 128, &key, expected),
+              8);
+    ASSERT_EQ(scanSlots(slots.data(), 8, 128, 128, &key, classes), 8);
+    EXPECT_EQ(memcmp(classes, expected, sizeof(classes)), 0);
+    EXPECT_FALSE(classes[1] & guard::SLOT_MATCH);
+    for (size_t pos : {0, 2, 3, 4, 5, 6, 7})
+    {
+        EXPECT_TRUE(classes[pos] & guard::SLOT_MATCH) << "slot " << pos;
+    }
+}
+
+TEST(TestGuardScan, InvalidKey)
+{
+    // Entity path with more elements than it can hold matches nothing
+    guard::EntityPath key = makePath(11, 5);
+    auto slots = makeSlots(16, 128, 16, key);
+    uint8_t classes[16];
+    ASSERT_EQ(scanSlots(slots.data(), 16, 128, 128, &key, classes), 16);
+    for (size_t pos = 0; pos < 16; pos++)
+    {
+        EXPECT_FALSE(classes[pos] & guard::SLOT_MATCH);
+    }
+}
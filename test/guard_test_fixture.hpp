@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "libguard/guard_entity.hpp"
+#include "libguard/guard_interface.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <stdlib.h>
+
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+
+#include <gtest/gtest.h>
+
+/**
+ * @class GuardFileTest
+ *
+ * Fixture of the tests with a blank GUARD file of 656 bytes in a temporary
+ * directory, which is set as the guard file in use. libguard_init() is
+ * not called so, the tests can change the GUARD file before that.
+ */
+class GuardFileTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/FakeGuard.XXXXXX";
+        auto dirPtr = mkdtemp(dirTemplate);
+        if (dirPtr == NULL)
+        {
+            throw std::bad_alloc();
+        }
+        guardDir = std::string(dirPtr);
+        guardFile = guardDir + "/GUARD";
+
+        //! create a guard file
+        createFile(guardFile, 656);
+        //! set guard file to use
+        openpower::guard::utest::setGuardFile(guardFile);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(guardDir);
+    }
+
+    /**
+     * @brief Create the erased GUARD file of the given size
+     */
+    static void createFile(const std::filesystem::path& path, size_t size)
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        std::string buf(size, '\xff');
+        file.write(buf.data(), buf.size());
+    }
+
+    /**
+     * @brief Return the entity path of the DIMM
+     */
+    static openpower::guard::EntityPath dimm(int instance)
+    {
+        return *openpower::guard::getEntityPath("/sys-0/node-0/dimm-" +
+                                                std::to_string(instance));
+    }
+
+  protected:
+    std::filesystem::path guardFile;
+    std::string guardDir;
+};
+
+/**
+ * @class InitializedGuardFileTest
+ *
+ * GuardFileTest with libguard initialized for the GUARD file
+ */
+class InitializedGuardFileTest : public GuardFileTest
+{
+  public:
+    void SetUp() override
+    {
+        GuardFileTest::SetUp();
+        openpower::guard::libguard_init();
+    }
+};
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "config.h"
+
+#include "guard_test_fixture.hpp"
+#include "libguard/guard_entity.hpp"
+#include "libguard/guard_file.hpp"
+#include "libguard/guard_interface.hpp"
+#include "libguard/guard_watch.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <endian.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace guard = openpower::guard;
+
+class TestGuardWatcher : public InitializedGuardFileTest
+{
+  public:
+    /**
+     * @brief Wait until the watcher delivers the changes
+     */
+    guard::GuardEvents waitEvents(guard::GuardWatcher& watcher)
+    {
+        guard::GuardEvents received;
+        int id = watcher.subscribe([&received](const guard::GuardEvents& e) {
+            received.insert(received.end(), e.begin(), e.end());
+        });
+        auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (received.empty() && (std::chrono::steady_clock::now() < end))
+        {
+            watcher.wait(100);
+        }
+        watcher.unsubscribe(id);
+        return received;
+    }
+};
+
+TEST_F(TestGuardWatcher, Diff)
+{
+    auto dimm0 = guard::getEntityPath("/sys-0/node-0/dimm-0");
+    auto dimm1 = guard::getEntityPath("/sys-0/node-0/dimm-1");
+    guard::GuardRecord record0 = guard::create(*dimm0);
+    guard::GuardRecord record1 = guard::create(*dimm1);
+    guard::GuardRecords before{record0, record1};
+
+    guard::GuardRecords after{record0, record1};
+    after[0].recordId = GUARD_RESOLVED;
+    after[1].errType = guard::GARD_Predictive;
+    after.push_back(record0);
+    after[2].recordId = 3;
+
+    auto events = guard::GuardWatcher::diff(before, after);
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(events[0].type, guard::GuardEvent::Type::Resolved);
+    EXPECT_EQ(events[0].record.recordId, 1);
+    EXPECT_EQ(events[1].type, guard::GuardEvent::Type::Overwritten);
+    EXPECT_EQ(events[1].previous.errType, guard::GARD_User_Manual);
+    EXPECT_EQ(events[1].record.errType, guard::GARD_Predictive);
+    EXPECT_EQ(events[2].type, guard::GuardEvent::Type::Added);
+    EXPECT_EQ(events[2].record.recordId, 3);
+
+    EXPECT_TRUE(guard::GuardWatcher::diff(after, after).empty());
+}
+
+TEST_F(TestGuardWatcher, WatchChanges)
+{
+    guard::GuardWatcher watcher;
+    auto dimm0 = guard::getEntityPath("/sys-0/node-0/dimm-0");
+
+    guard::create(*dimm0);
+    auto events = waitEvents(watcher);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, guard::GuardEvent::Type::Added);
+    EXPECT_EQ(events[0].record.targetId, dimm0);
+
+    guard::create(*dimm0, 0x10, guard::GARD_Predictive);
+    events = waitEvents(watcher);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, guard::GuardEvent::Type::Overwritten);
+    EXPECT_EQ(events[0].record.elogId, 0x10);
+
+    guard::clear(*dimm0, true);
+    events = waitEvents(watcher);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, guard::GuardEvent::Type::Resolved);
+    EXPECT_EQ(events[0].record.recordId, 1);
+}
+
+#if defined(GUARD_RECORD_CRC) && !defined(PGUARD)
+TEST_F(TestGuardWatcher, CorruptedRecordKeepsSlots)
+{
+    guard::create(dimm(0));
+    guard::create(dimm(1));
+    guard::create(dimm(2));
+    guard::GuardWatcher watcher;
+
+    // Flipped bit in the first record, which getAll() skips now
+    {
+        guard::GuardRecord record;
+        guard::GuardFile file(guardFile);
+        file.read(16, &record, sizeof(record));
+        record.elogId ^= htobe32(0x10);
+        file.write(16, &record, sizeof(record));
+    }
+    auto events = waitEvents(watcher);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, guard::GuardEvent::Type::Resolved);
+    EXPECT_EQ(events[0].record.targetId, dimm(0));
+
+    // The records after it are still compared with their own slot
+    guard::clear(dimm(2));
+    events = waitEvents(watcher);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, guard::GuardEvent::Type::Resolved);
+    EXPECT_EQ(events[0].record.targetId, dimm(2));
+}
+#endif
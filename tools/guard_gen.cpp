@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "libguard/guard_entity.hpp"
+#include "libguard/guard_entity_map.hpp"
+#include "libguard/include/guard_record.hpp"
+
+#include <endian.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+
+using namespace openpower::guard;
+
+/**
+ * Fields common to the standard and the PGUARD record layout, the rest
+ * of the record is left as 0xFF like the records created by libguard.
+ */
+struct RecordPrefix
+{
+    uint32_t recordId;
+    EntityPath targetId;
+    uint32_t elogId;
+    uint8_t errType;
+} __attribute__((__packed__));
+
+/**
+ * Layouts of the GUARD partition
+ *
+ * The standard layout has "GUARDREC" header followed by 128 bytes records.
+ * The PGUARD layout has no header and 37 bytes records.
+ */
+struct PartitionLayout
+{
+    size_t headerSize;
+    size_t recordSize;
+};
+
+static const std::map<std::string, PartitionLayout> layouts = {
+    {"standard", {16, 128}}, {"pguard", {0, 37}}};
+
+static_assert(sizeof(RecordPrefix) == offsetof(GuardRecord, elogId) +
+                                          sizeof(uint32_t) + sizeof(uint8_t),
+              "RecordPrefix does not match with GuardRecord");
+
+/**
+ * @brief Parse the GardType mix
+ *
+ * @param[in] typeMix comma separated list of <type>:<weight> where type is
+ *                    name of GardType as listed by the guard tool
+ *                    e.g. "predictive:6,manual:3,reconfig:1"
+ * @param[out] types GardType values
+ * @param[out] weights weight of each GardType
+ *
+ * @return NULL
+ */
+static void parseTypeMix(const std::string& typeMix,
+                         std::vector<uint8_t>& types,
+                         std::vector<unsigned>& weights)
+{
+    std::stringstream mix(typeMix);
+    std::string item;
+    while (std::getline(mix, item, ','))
+    {
+        auto sep = item.find(':');
+        std::string name = item.substr(0, sep);
+        unsigned weight = 1;
+        if (sep != std::string::npos)
+        {
+            weight = std::stoul(item.substr(sep + 1));
+        }
+        auto type = std::find_if(
+            guardreason.begin(), guardreason.end(),
+            [&name](const auto& reason) { return reason.second == name; });
+        if (type == guardreason.end())
+        {
+            throw std::invalid_argument("Unknown GardType " + name);
+        }
+        types.push_back(type->first);
+        weights.push_back(weight);
+    }
+    if (types.empty())
+    {
+        throw std::invalid_argument("Empty GardType mix");
+    }
+}
+
+/**
+ * @brief Return an unique target to guard
+ *
+ * The target is taken from the physical path list and, its last path
+ * element instance is randomised so, the partitions can have more records
+ * than the number of targets in the list.
+ *
+ * @param[in] rng random number generator
+ * @param[in,out] usedPaths entity paths which are already guarded
+ * @param[out] physicalPath physical path of the returned target
+ *
+ * @return entity path of the target
+ */
+static EntityPath getUniqueTarget(
+    std::mt19937& rng,
+    std::unordered_set<EntityPath, EntityPathHash>& usedPaths,
+    std::string& physicalPath)
+{
+    std::uniform_int_distribution<size_t> pick(
+        1, physicalEntityPathMap.size() - 1);
+    std::uniform_int_distribution<unsigned> instance(0, 0xFF);
+    while (true)
+    {
+        auto target = std::next(physicalEntityPathMap.begin(), pick(rng));
+        size_t elements = target->second.type_size & 0x0F;
+        // Copy only the used path elements to keep the output reproducible
+        EntityPath entityPath{};
+        entityPath.type_size = target->second.type_size;
+        std::copy_n(target->second.pathElements.begin(), elements,
+                    entityPath.pathElements.begin());
+        auto sep = target->first.rfind('-');
+        if ((elements == 0) || (sep == std::string::npos))
+        {
+            continue;
+        }
+        auto& last = entityPath.pathElements[elements - 1];
+        last.instance = static_cast<uint8_t>(instance(rng));
+        if (!usedPaths.insert(entityPath).second)
+        {
+            continue;
+        }
+        physicalPath = target->first.substr(0, sep + 1) +
+                       std::to_string(last.instance);
+        return entityPath;
+    }
+}
+
+/**
+ * @brief Write the physical path of the guarded targets
+ *
+ * Format: "physical:<physical path> <entity path bytes in hex>", one
+ * target per line which is the format of the synthetic device tree used
+ * by the devtree tests.
+ *
+ * @param[in] file file to write
+ * @param[in] physicalPaths physical path of the targets
+ * @param[in] entityPaths entity path of the targets
+ *
+ * @return NULL
+ */
+static void writePathTable(const std::string& file,
+                           const std::vector<std::string>& physicalPaths,
+                           const std::vector<EntityPath>& entityPaths)
+{
+    std::ofstream table(file, std::ios::out | std::ios::trunc);
+    for (size_t i = 0; i < physicalPaths.size(); i++)
+    {
+        const auto& entityPath = entityPaths[i];
+        // The stored physical path is without the leading '/'
+        table << "physical:" << physicalPaths[i].substr(1) << " " << std::hex
+              << static_cast<int>(entityPath.type_size);
+        for (int elem = 0; elem < (entityPath.type_size & 0x0F); elem++)
+        {
+            table << " "
+                  << static_cast<int>(entityPath.pathElements[elem].targetType)
+                  << " "
+                  << static_cast<int>(entityPath.pathElements[elem].instance);
+        }
+        table << std::dec << "\n";
+    }
+    if (!table)
+    {
+        throw std::runtime_error("Failed to write " + file);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        CLI::App app{"Synthetic GUARD partition generator"};
+        std::string output;
+        std::string layoutName = "standard";
+        size_t capacity = 0;
+        size_t records = 0;
+        std::string typeMix = "predictive";
+        double resolvedRatio = 0;
+        uint32_t seed = 1;
+        std::optional<std::string> pathTable;
+
+        app.set_help_flag("-h, --help", "Guard generator options");
+        app.add_option("-o, --output", output, "GUARD partition file to write")
+            ->required();
+        app.add_option("-l, --layout", layoutName,
+                       "Layout of the partition, standard or pguard")
+            ->check(CLI::IsMember({"standard", "pguard"}));
+        app.add_option("-c, --capacity", capacity,
+                       "Number of record slots in the partition")
+            ->required();
+        app.add_option("-n, --records", records,
+                       "Number of records, resolved records included");
+        app.add_option("-t, --types", typeMix,
+                       "GardType mix as <type>:<weight>, comma separated "
+                       "e.g. predictive:6,manual:3,reconfig:1");
+        app.add_option("-r, --resolved", resolvedRatio,
+                       "Ratio of the resolved records, 0 to 1")
+            ->check(CLI::Range(0.0, 1.0));
+        app.add_option("-s, --seed", seed, "Seed of the random generator");
+        app.add_option("-p, --paths", pathTable,
+                       "File to write the physical path of the guarded "
+                       "targets");
+
+        CLI11_PARSE(app, argc, argv);
+
+        if (records > capacity)
+        {
+            throw std::invalid_argument(
+                "Number of records is more than the capacity");
+        }
+        const auto& layout = layouts.at(layoutName);
+        std::vector<uint8_t> types;
+        std::vector<unsigned> weights;
+        parseTypeMix(typeMix, types, weights);
+
+        std::mt19937 rng(seed);
+        std::discrete_distribution<size_t> pickType(weights.begin(),
+                                                    weights.end());
+        std::bernoulli_distribution isResolved(resolvedRatio);
+        std::uniform_int_distribution<uint32_t> elogId(0x90000000,
+                                                       0x9FFFFFFF);
+        std::unordered_set<EntityPath, EntityPathHash> usedPaths;
+        std::vector<std::string> physicalPaths;
+        std::vector<EntityPath> entityPaths;
+
+        // Erased flash is 0xFF, that is blank header padding and records
+        std::vector<uint8_t> partition(
+            layout.headerSize + capacity * layout.recordSize, 0xFF);
+        if (layout.headerSize != 0)
+        {
+            memcpy(partition.data(), GUARD_MAGIC, strlen(GUARD_MAGIC));
+            partition[strlen(GUARD_MAGIC)] = CURRENT_GARD_VERSION_LAYOUT;
+        }
+
+        // Records are written from the first slot without gap since the
+        // first blank slot ends the partition. Record id is increased for
+        // every record as libguard does, including the ones resolved later.
+        for (size_t i = 0; i < records; i++)
+        {
+            RecordPrefix record;
+            std::string physicalPath;
+            record.targetId = getUniqueTarget(rng, usedPaths, physicalPath);
+            record.recordId = isResolved(rng)
+                                  ? GUARD_RESOLVED
+                                  : htobe32(static_cast<uint32_t>(i + 1));
+            record.elogId = htobe32(elogId(rng));
+            record.errType = types[pickType(rng)];
+            memcpy(partition.data() + layout.headerSize +
+                       i * layout.recordSize,
+                   &record, sizeof(record));
+            physicalPaths.push_back(std::move(physicalPath));
+            entityPaths.push_back(record.targetId);
+        }
+
+        std::ofstream file(output, std::ios::out | std::ios::binary |
+                                       std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(partition.data()),
+                   partition.size());
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write " + output);
+        }
+        if (pathTable)
+        {
+            writePathTable(*pathTable, physicalPaths, entityPaths);
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}